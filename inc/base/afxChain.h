@@ -85,6 +85,9 @@ AFXINL afxResult        AfxChainEnumerateLinkages(afxChain *ch, afxBool reverse,
 
 AFXINL afxUnit          AfxInvokeLinkages(afxChain *ch, afxBool fromLast, afxUnit first, afxUnit cnt, afxBool(*f)(afxLink *lnk, void *udd), void *udd);
 
+/// Gathers the links into a temporary array, in the order AfxInvokeLinkages() would visit them, then invokes f over it in parallel on the system service. The chain must not be modified while it runs.
+AFX afxUnit             AfxInvokeLinkagesParallel(afxChain *ch, afxBool fromLast, afxUnit first, afxUnit cnt, afxUnit grain, afxParallelFlags flags, afxBool(*f)(afxLink *lnk, void *udd), void *udd);
+
 AFXINL void             AfxResetLink(afxLink *lnk);
 AFXINL afxUnit          AfxPushLink(afxLink *lnk, afxChain *ch);
 AFXINL afxUnit          AfxPushBackLink(afxLink *lnk, afxChain *ch);
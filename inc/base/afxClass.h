@@ -95,6 +95,8 @@ AFX_DEFINE_STRUCT(afxClassConfig)
     afxUnit         unitsPerPage;
     afxUnit         suballocCnt;
     afxClassSuballocation const* suballocs;
+    afxUnit         parallelCtorGrain; // objects per job when a batch is constructed on the worker pool. If zero, ctor is never run concurrently; set it only if ctor is safe to run concurrently for distinct objects.
+    afxArenaSpecification const* arenaSpec; // forwarded to AfxDeployArena() for afxClass::arena and afxClass::extraAlloc, e.g. to make them adaptive and keep them warm. If NIL, the defaults are used.
 };
 
 AFX_DEFINE_STRUCT(afxObjectChunk)
@@ -119,6 +121,31 @@ AFX_DEFINE_STRUCT(afxClassExtension)
     afxSize         (*ioSizCb)(afxObject obj, void* ext, afxUnit siz); // determines the binary size of the extension data.
 };
 
+/// HANDLE TABLE
+/// Each class maps its instances through a generational slot table. An afxObjectHandle (see afxObject.h) is the slot index paired with the slot generation.
+/// The slot index is the pool index of the instance (its instIdx), so slots are recycled along with pool units and the table keeps no free list of its own.
+/// The generation is bumped twice per lifetime: to odd when the instance is constructed and to even when it is destructed, 
+/// so a stale handle fails to resolve without its freed memory ever being read.
+/// Static instances, which are not allocated from the class pool, have no slot; AfxGetObjectHandle() returns AFX_INVALID_HANDLE for them.
+/// Slots live in fixed-size pages reached through a fixed-size directory; neither ever moves or is freed before the class is dismantled,
+/// so resolution is a lock-free O(1) lookup even while pages are being added. A class holds at most AFX_HANDLE_PAGE_CNT * AFX_HANDLE_SLOTS_PER_PAGE instances.
+/// Handles carry no class identity; resolving a handle against a class other than the one which issued it yields an unrelated instance or NIL.
+
+#define AFX_HANDLE_SLOTS_PER_PAGE 1024
+#define AFX_HANDLE_PAGE_CNT 1024
+
+AFX_DEFINE_STRUCT(afxHandleSlot)
+{
+    afxAtom32       gen; // bumped to odd on construction and to even on destruction; zero, never live, makes no valid handle.
+    afxAtomPtr      obj;
+};
+
+AFX_DEFINE_STRUCT(afxHandleTable)
+{
+    afxUnit         pageCnt; // pages in use; grown under afxClass::poolLock.
+    afxAtomPtr      pages[AFX_HANDLE_PAGE_CNT]; // afxHandleSlot[AFX_HANDLE_SLOTS_PER_PAGE], published with a release store; NIL until needed.
+};
+
 AFX_DEFINE_STRUCT(afxClassVmt)
 {
     afxBool(*release)(afxUnit cnt, afxObject objects[]);
@@ -144,8 +171,10 @@ AFX_DEFINE_STRUCT(afxClass)
     afxSlock        poolLock;
     afxUnit         unitsPerPage; // when pool gets empty, the class will try to resizes storage pages to this value. If zero, the new page will be set to the size of the first batch allocation when pool was zero.
     afxUnit         uniqueInc;
+    afxUnit         parallelCtorGrain;
 
-    afxArena        arena; // used to allocate class/struct suballocations for members.
+    afxArena        arena; // used to allocate class/struct suballocations for members. Deployed from afxClassConfig::arenaSpec.
+    afxHandleTable  handles;
 
     afxError        (*ctor)(afxObject obj, void** args, afxUnit invokeNo); // void to avoid warnings
     afxError        (*dtor)(afxObject obj);
@@ -157,7 +186,7 @@ AFX_DEFINE_STRUCT(afxClass)
     
     afxChain        extensions;
     afxUnit         extraSiz; // extra size contributed by each plugin.
-    afxArena        extraAlloc; // plugin space allocation.
+    afxArena        extraAlloc; // plugin space allocation. Deployed from afxClassConfig::arenaSpec.
 
     afxBool         (*defEvent)(afxObject obj, afxEvent *ev);
     afxBool         (*defEventFilter)(afxObject obj, afxObject watched, afxEvent *ev);
@@ -182,6 +211,14 @@ AFXINL afxArena*    AfxGetClassArena(afxClass *cls);
 AFXINL afxClass*    AfxGetSubClass(afxClass const* cls);
 AFXINL afxObject    AfxGetClassInstance(afxClass const* cls, afxUnit32 uniqueId);
 
+/// Resolves a handle issued by cls in O(1). Returns FALSE, setting obj to NIL, if the handle is stale or out of range. Safe in release builds.
+AFXINL afxBool      AfxResolveHandle(afxClass const* cls, afxObjectHandle h, afxObject* obj);
+
+/// Resolves cnt handles; stale ones resolve to NIL. Returns the number of stale handles.
+AFX afxUnit         AfxResolveHandles(afxClass const* cls, afxUnit cnt, afxObjectHandle const handles[], afxObject objects[]);
+
+AFXINL afxBool      AfxIsHandleAlive(afxClass const* cls, afxObjectHandle h);
+
 // Pass NIL into objects to AfxEnumerateObjects() to return a total number of instances.
 
 AFX afxUnit         AfxEnumerateObjects(afxClass const* cls, afxUnit first, afxUnit cnt, afxObject objects[]);
@@ -199,12 +236,26 @@ AFX afxUnit         AfxInvokeObjects(afxClass const* cls, afxUnit first, afxUnit
 /// However, AfxInvokeClassInstances2 will return count of objects that passed in flt() callback.
 AFX afxUnit         AfxInvokeClassInstances2(afxClass const* cls, afxUnit first, afxUnit cnt, afxBool(*f)(afxObject,void*), void* udd, afxBool(*f2)(afxObject,void*), void* udd2);
 
+/// Parallel counterpart of AfxInvokeObjects(); the class pool is held shared while it runs. See AfxInvokePoolItemsParallel().
+AFX afxUnit         AfxInvokeObjectsParallel(afxClass const* cls, afxUnit first, afxUnit cnt, afxUnit grain, afxParallelFlags flags, afxBool(*f)(afxObject obj, void *udd), void* udd);
+
+/// Parallel reduction over the instances of a class. See AfxParallelReduce().
+AFX afxError        AfxReduceObjectsParallel(afxClass const* cls, afxUnit grain, afxParallelFlags flags, afxUnit partialSiz, void const* identity, void(*f)(afxObject obj, void* partial, void* udd), void(*combine)(void* acc, void const* partial, void* udd), void* udd, void* result);
+
 AFX afxError        _AfxDeallocateObjects(afxClass* cls, afxUnit cnt, afxObject objects[]);
 AFX afxError        _AfxAllocateObjects(afxClass* cls, afxUnit cnt, afxObject objects[]);
 AFX afxError        _AfxAllocateClassInstancesAt(afxClass* cls, afxUnit base, afxUnit cnt, afxObject objects[]);
 AFX afxError        _AfxDestructObjects(afxClass* cls, afxUnit cnt, afxObject objects[]);
 AFX afxError        _AfxConstructObjects(afxClass* cls, afxUnit cnt, afxObject objects[], void** udd);
 
+/// Bulk path of AfxAcquireObjects(): reserves the batch as consecutive per-page pool runs (see AfxPushPoolRun()), and assigns instance indices and handle slots, under a single acquisition of poolLock.
+/// Batches larger than unitsPerPage are only contiguous within each page; classes expecting large batches should set unitsPerPage accordingly.
+AFX afxError        _AfxAllocateObjectRun(afxClass* cls, afxUnit cnt, afxObject objects[]);
+
+/// Runs ctor over the batch, split in parallelCtorGrain-sized jobs on the system worker pool when the class allows it and cnt is large enough.
+/// On failure, every object successfully constructed is destructed, in any order.
+AFX afxError        _AfxConstructObjectRun(afxClass* cls, afxUnit cnt, afxObject objects[], void** udd);
+
 AFX afxResult       AfxDeregisterChainedClasses(afxChain* ch);
 AFX afxResult       AfxExhaustChainedClasses(afxChain* ch);
 AFX afxChain*       _AfxGetOrphanClasses(void);
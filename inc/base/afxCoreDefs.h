@@ -47,6 +47,7 @@
 
 #define AFX_SIMD_ALIGNMENT 16u
 #define AFX_PTR_ALIGNMENT sizeof(void*)
+#define AFX_CACHE_LINE_SIZ 64u // used to pad data written by distinct threads apart.
 #define AFX_DEFAULT_ALIGNMENT AFX_PTR_ALIGNMENT
 
 #define AFX_DEFINE_HANDLE(object) typedef struct object##_T* object
@@ -285,7 +286,13 @@ AFX_CALLBACK(void, afxCallbackFunc) // Function called on completion of an event
     afxCallbackInfo* in_pCallbackInfo                    ///< Structure containing desired information. You can cast it to the proper sub-type, depending on the callback type.
 );
 
-#define AFX_NUM_JOB_TYPES 1
+#define AFX_NUM_JOB_TYPES 2
+
+// Flags for parallel loops and invocations run on an afxService; see afxService.h.
+typedef enum afxParallelFlag
+{
+    afxParallelFlag_DETERMINISTIC   = AFX_BIT(0),
+} afxParallelFlags;
 
 // Function that the host runtime must call to allow for jobs to execute.
 // in_jobType is the type originally provided by FuncRequestJobWorker.
@@ -302,6 +309,12 @@ typedef afxUnit aaxUniqueId;
 
 AFX afxUnit AfxFlagsFindLsb(afxFlags mask);
 AFX afxUnit AfxFlagsFindMsb(afxFlags mask);
+AFX afxUnit AfxFlagsCountBits(afxFlags mask);
+
+// 64-bit wide variants, used by bitmaps; mapped to tzcnt/lzcnt/popcnt where the ISA provides them. Finders return AFX_INVALID_INDEX if mask is zero.
+AFX afxUnit AfxFlagsFindLsb64(afxMask64 mask);
+AFX afxUnit AfxFlagsFindMsb64(afxMask64 mask);
+AFX afxUnit AfxFlagsCountBits64(afxMask64 mask);
 
 #define AfxTestBitPosition(mask_,bit_) ((mask_) &  (1 << (bit_))) // Return bit position or 0 depending on if the bit is actually enabled.
 #define AfxTestBitEnabled(mask_,bit_) (((mask_)>>(bit_)) & 1) // Return 1 or 0 if bit is enabled and not the position;
@@ -105,6 +105,11 @@ typedef enum afxFcc
     afxFcc_IOB      = AFX_MAKE_FCC('i', 'o', 'b', '\0'), // afxStream
     afxFcc_IOS      = AFX_MAKE_FCC('i', 'o', 's', '\0'), // afxStream
     afxFcc_CDC      = AFX_MAKE_FCC('c', 'd', 'c', '\0'), // afxCodec
+    afxFcc_RAW      = AFX_MAKE_FCC('r', 'a', 'w', '\0'), // uncompressed data
+    afxFcc_RLE      = AFX_MAKE_FCC('r', 'l', 'e', '\0'), // run-length encoded data
+    afxFcc_LZ4      = AFX_MAKE_FCC('l', 'z', '4', '\0'), // LZ4 block
+    afxFcc_LZ4F     = AFX_MAKE_FCC('l', 'z', '4', 'f'), // LZ4 frame
+    afxFcc_ZSTD     = AFX_MAKE_FCC('z', 's', 't', 'd'), // Zstandard frame
     afxFcc_FSSP     = AFX_MAKE_FCC('f', 's', 's', 'p'), // afxStoragePoint
     afxFcc_STO      = AFX_MAKE_FCC('s', 't', 'o', '\0'), // afxStorage
     afxFcc_ARC      = AFX_MAKE_FCC('a', 'r', 'c', '\0'), // afxArchive
@@ -73,6 +73,14 @@ typedef enum afxObjectFlag
 typedef void* afxObject;
 #define AfxObjects(_objets_) ((afxObject*)_objets_)
 
+// Generational handle: slot index in the low 32 bits, slot generation in the high 32 bits.
+typedef afxUnit64 afxObjectHandle;
+
+#define AFX_INVALID_HANDLE ((afxObjectHandle)0)
+#define AfxGetHandleIndex(h_) ((afxUnit32)((h_) & 0xFFFFFFFF))
+#define AfxGetHandleGeneration(h_) ((afxUnit32)((h_) >> 32))
+#define AfxMakeHandle(idx_, gen_) ((((afxObjectHandle)(gen_)) << 32) | (afxObjectHandle)(afxUnit32)(idx_))
+
 AFX_DECLARE_STRUCT(afxEvent);
 
 AFX_DEFINE_STRUCT(afxEvent)
@@ -92,6 +100,8 @@ AFX_DEFINE_STRUCT(afxPostedEvent)
     afxObject       receiver;
     afxUnit          priority;
     afxUnit          siz;
+    afxUnit32       coalesceSlot; // index plus one of the coalesce slot holding the payload; zero if the event was not coalesced.
+    afxAtomPtr      next; // chained in the overflow list of an inbox.
     afxByte         ev[];
 };
 
@@ -99,6 +109,7 @@ AFX_DEFINE_STRUCT(afxObjectBase)
 {
     afxFcc              fcc; // OBJ
     afxUnit             instIdx; // read-only
+    afxUnit32           handleGen; // read-only; generation of the handle slot, which is indexed by instIdx.
     afxObjectFlags      flags;
     afxAtom32           refCnt;
     afxUnit32           tid;
@@ -155,6 +166,7 @@ AFXINL afxError         AfxDeallocateInstanceData(afxObject obj, afxUnit cnt, af
 // %p?%.4s#%i
 #define AfxPushObject(obj_) 0,0,0//(obj_), (obj_) ? AfxGetObjectFccAsString((afxHandle*)obj_) : NIL, (obj_) ? ((afxHandle*)obj_)->refCnt : 0
 
+/// Batches are allocated as per-page contiguous runs under one lock acquisition and, for classes which allow it, constructed in parallel. See _AfxAllocateObjectRun().
 AFX afxError    AfxAcquireObjects(afxClass* cls, afxUnit cnt, afxObject objects[], void const* udd[]);
 AFX afxError    AfxReacquireObjects(afxUnit cnt, afxObject objects[]);
 AFX afxBool     AfxDisposeObjects(afxUnit cnt, afxObject objects[]);
@@ -181,6 +193,9 @@ AFX afxUnit      _AfxTryAssertObjects(afxUnit cnt, afxObject const objects[], af
 
 AFX afxUnit      AfxGetObjectId(afxObject obj);
 
+/// Returns the generational handle of the object in the handle table of its class, or AFX_INVALID_HANDLE for static instances, which have no slot. See AfxResolveHandle().
+AFXINL afxObjectHandle AfxGetObjectHandle(afxObject obj);
+
 AFX afxResult   AfxWaitForObject(afxTime timeout, afxObject obj);
 
 #endif//AFX_OBJECT_H
@@ -34,6 +34,43 @@ AFXINL void     AfxCopyClock(afxClock* clock, afxClock const* src);
 /// Find out how many seconds have elapsed from a previous clock up to another clock.
 AFX afxReal64   AfxGetSecondsElapsed(afxClock const* from, afxClock const* until);
 
+/// TIMING HISTOGRAMS
+/// Durations are counted in log-linear buckets: AFX_TIMING_SUBBUCKET_CNT per power of two of microseconds, from 1 us up to about 16 s.
+/// Recording is a bit scan and an increment; percentiles are read back within 1 / AFX_TIMING_SUBBUCKET_CNT of relative error,
+/// about 3%, or +/-0.5 ms at a 16.6 ms frame, which is fine enough to tell frame jitter apart. Each histogram takes 3 KiB.
+
+#define AFX_TIMING_OCTAVE_CNT 24
+#define AFX_TIMING_SUBBUCKET_CNT 32
+#define AFX_TIMING_BUCKET_CNT (AFX_TIMING_OCTAVE_CNT * AFX_TIMING_SUBBUCKET_CNT)
+
+AFX_DEFINE_STRUCT(afxTimingHistogram)
+{
+    afxUnit32   buckets[AFX_TIMING_BUCKET_CNT];
+    afxUnit32   sampleCnt;
+    afxReal64   sum; // seconds
+    afxReal64   max; // seconds
+};
+
+AFX_DEFINE_STRUCT(afxTimingStats)
+/// All values in seconds.
+{
+    afxUnit     sampleCnt;
+    afxReal64   mean;
+    afxReal64   p50;
+    afxReal64   p95;
+    afxReal64   p99;
+    afxReal64   max;
+};
+
+AFXINL void     AfxResetTimingHistogram(afxTimingHistogram* hist);
+
+AFXINL void     AfxRecordTiming(afxTimingHistogram* hist, afxReal64 secs);
+
+/// Accumulates src into hist.
+AFXINL void     AfxMergeTimingHistogram(afxTimingHistogram* hist, afxTimingHistogram const* src);
+
+AFX void        AfxDescribeTimingHistogram(afxTimingHistogram const* hist, afxTimingStats* stats);
+
 /*
     afxClock last;
     AfxGetClock(&last);
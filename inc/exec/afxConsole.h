@@ -30,4 +30,7 @@ AFX afxResult   AfxPrompt(afxString const* cur, afxString* buf);
 AFX afxResult   AfxPrint(afxUnit32 color, afxChar const* msg);
 AFX afxResult   AfxPrintf(afxUnit32 color, afxChar const* msg, ...);
 
+/// Prints the rolling loop timing statistics (p50/p95/p99/max) of every thread. See AfxGetThreadTiming().
+AFX afxResult   AfxPrintThreadTimings(void);
+
 #endif//AFX_CONSOLE_H
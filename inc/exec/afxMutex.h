@@ -36,6 +36,31 @@
 
 */
 
+typedef enum afxMutexType
+{
+    AFX_MTX_PLAIN,
+    AFX_MTX_TIMED,
+    AFX_MTX_RECURSIVE,
+    AFX_MTX_ADAPTIVE, // spins with pause and exponential backoff for up to spinCnt iterations, then parks on a futex. Supports timed locking. Not recursive.
+} afxMutexType;
+
+typedef enum afxMutexFlag
+{
+    afxMutexFlag_INSTRUMENTED   = AFX_BIT(0), // count contention; see AfxDescribeMutexContention().
+} afxMutexFlags;
+
+#define AFX_MTX_DEF_SPIN_CNT 100
+
+AFX_DEFINE_STRUCT(afxLockStats)
+/// Contention counters of a lock. Only kept for instrumented locks.
+{
+    afxUnit64   acquireCnt;
+    afxUnit64   contendedCnt; // acquisitions which found the lock held.
+    afxUnit64   spinAcquireCnt; // contended acquisitions satisfied while spinning.
+    afxUnit64   parkCnt; // contended acquisitions which had to park.
+    afxUnit64   waitTicks; // total ticks (see AfxGetTickCounter()) spent waiting.
+};
+
 AFX_DEFINE_STRUCT(afxMutex)
 {
 #ifdef AFX_OS_WIN
@@ -49,16 +74,20 @@ AFX_DEFINE_STRUCT(afxMutex)
 #else
     afxAtom32   data[12]; // 48 bytes
 #endif
+    // kept apart from the OS mutex storage above, which it fully occupies.
+    afxUnit32   spinCnt; // AFX_MTX_ADAPTIVE only.
+    afxMutexFlags flags;
+    afxLockStats* stats; // instrumented only.
 };
 
-typedef enum afxMutexType
-{
-    AFX_MTX_PLAIN,
-    AFX_MTX_TIMED,
-    AFX_MTX_RECURSIVE
-} afxMutexType;
-
 AFX afxError        AfxDeployMutex(afxMutex* mtx, afxMutexType type);
+
+/// Same as AfxDeployMutex(), with flags and the spin budget of AFX_MTX_ADAPTIVE. If spinCnt is zero, AFX_MTX_DEF_SPIN_CNT is used.
+/// Counters of instrumented mutexes are allocated apart from the mutex, as for afxSlock.
+AFX afxError        AfxDeployMutex2(afxMutex* mtx, afxMutexType type, afxMutexFlags flags, afxUnit spinCnt);
+
+/// Returns FALSE if the mutex is not instrumented.
+AFX afxBool         AfxDescribeMutexContention(afxMutex* mtx, afxLockStats* stats);
 AFX void            AfxDismantleMutex(afxMutex* mtx);
 
 AFX afxError        AfxLockMutex(afxMutex* mtx);
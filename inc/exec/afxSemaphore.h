@@ -32,12 +32,46 @@
 #define AFX_SEMAPHORE_H
 
 #include "qwadro/inc/base/afxChain.h"
+#include "qwadro/inc/exec/afxSlock.h"
+
+/**
+    HOST WAITS
+    A host waiter registers one node per semaphore it waits on, all sharing a wait word on its stack, then parks on that word with a futex (wait-on-address on Windows).
+    Nodes are kept sorted by threshold; a signal only walks and wakes the nodes whose threshold the new value reached.
+    With waitAll, a node decrements its waiter's remaining count and the waiter is woken when it reaches zero; otherwise the first reached node wakes it.
+*/
+
+#ifdef _AFX_CORE_C
+#ifdef _AFX_SEMAPHORE_C
+AFX_DEFINE_STRUCT(afxSemaphoreWaiter)
+{
+    afxAtom32           word; // futex word; bumped to wake.
+    afxAtom32           remaining; // semaphores still to be reached.
+};
+
+AFX_DEFINE_STRUCT(afxSemaphoreWaitNode)
+{
+    afxLink             sem; // afxSemaphore::waiters, sorted by threshold.
+    afxUnit64           threshold;
+    afxSemaphoreWaiter* waiter;
+    afxBool             reached;
+};
+
+AFX_OBJECT(afxSemaphore)
+{
+    void*               ctx;
+    afxAtom64           value;
+    afxSlock            waitersSlock;
+    afxChain            waiters; // afxSemaphoreWaitNode
+};
+#endif//_AFX_SEMAPHORE_C
+#endif//_AFX_CORE_C
 
 /// Return the draw context witch this semaphore belongs to.
 AFX void*               AfxGetSemaphoreContext(afxSemaphore sem);
 
 AFX afxError            AfxSignalSemaphore
-/// Signal a timeline semaphore on the host
+/// Signal a timeline semaphore on the host. The value must be greater than the current one. Only waiters whose threshold the value reaches are woken.
 (
     afxSemaphore        sem, /// the semaphore to signal.
     afxUnit64            value /// the value to signal.
@@ -52,6 +86,15 @@ AFX afxError            AfxGetSemaphoreValue
 
 ////////////////////////////////////////////////////////////////////////////////
 
+AFX afxError            AfxAcquireSemaphores2
+/// Create new timeline semaphore objects with initial payloads.
+(
+    void*               ctx, /// the logical device that creates the semaphore.
+    afxUnit             cnt,
+    afxUnit64 const     initialValues[], /// an array of cnt initial payloads; NIL to start all at zero.
+    afxSemaphore        semaphores[] /// a array of handles in which the resulting semaphore objects are returned.
+);
+
 AFX afxError            AfxAcquireSemaphores
 /// Create a new queue semaphore object.
 (
@@ -62,6 +105,7 @@ AFX afxError            AfxAcquireSemaphores
 
 AFX afxError            AfxWaitForSemaphores
 /// Wait for one or more timeline semaphores to reach particular counter values.
+/// The calling thread is parked, not polling. Returns afxError_TIMEOUT if the condition was not satisfied before timeout elapsed; a zero timeout only tests.
 (
     afxUnit64            timeout, /// the timeout period in units of nanoseconds.
     afxBool             waitAll, /// the condition is that all semaphores must reach the specified value, else at least one semaphore has reached.
@@ -21,30 +21,168 @@
 
 #include "qwadro/inc/io/afxStream.h"
 #include "qwadro/inc/mem/afxInterlockedQueue.h"
+#include "qwadro/inc/exec/afxThread.h"
+
+/**
+    afxService is a work-stealing job scheduler.
+
+    Each worker owns a Chase-Lev deque: it pushes and pops jobs at the bottom, while idle workers steal from the top of others.
+    Jobs submitted from threads which are not workers of the service go to a shared injection queue.
+    A job may be held behind a counter (dependency) and may signal a counter on completion; 
+    a job with a parent completes its parent only after all of its children completed.
+    Job storage is carved from the memory slabs configured in afxServiceConfig, one slab at a time per worker, so submission does not touch the MMU 
+    while slabs last. Each slab counts the jobs carved from it which have not completed yet; when the count drops to zero and the slab is no longer 
+    the current slab of a worker, it is recycled into the free slab list at once. When the free slab list is empty, a new slab is allocated from 
+    the MMU; slabs grown this way are kept for reuse and only freed with the service. AfxAllocateJob() thus returns NIL only if the MMU fails.
+*/
 
 typedef enum afxJobType
 {
-    afxJobType_
+    afxJobType_GENERAL, // short, non-blocking jobs.
+    afxJobType_BLOCKING, // jobs which may block (I/O, etc); run by workers requested separately so they never starve afxJobType_GENERAL.
+
+    afxJobType_TOTAL
 } afxJobType;
 
+AFX_STATIC_ASSERT(afxJobType_TOTAL == AFX_NUM_JOB_TYPES, "");
+
+AFX_DECLARE_STRUCT(afxJob);
+
+typedef void(*afxJobFn)(afxJob* job, void* udd);
+
 typedef void(*afxWorkerFn) (afxJobType typ, afxUnit execTimeUsec);
 
 /// Callback function prototype definition used for handling requests from service for new workers to perform work.
 typedef void(*afxReqWorkerFn)(afxWorkerFn workerFn, afxJobType typ, afxUnit workerCnt, void* udd);
 
+AFX_DEFINE_STRUCT(afxJobCounter)
+/// A counter is decremented by each job signaling it; jobs depending on it are held until it reaches zero.
+{
+    afxAtom32       value;
+    afxAtomPtr      waiters; // jobs held on this counter.
+};
+
+AFX_DEFINE_STRUCT(afxJob)
+{
+    afxJobFn        fn;
+    void*           udd[4];
+    afxJobType      typ;
+    afxJob*         parent; // NIL or a job which will only complete after this one.
+    afxAtom32       unfinished; // this job plus its unfinished children.
+    afxJobCounter*  signal; // NIL or decremented when this job completes.
+    afxJobCounter*  dependency; // NIL or held until it reaches zero.
+    afxJob*         nextWaiter; // chained in dependency->waiters.
+};
+
 AFX_DEFINE_STRUCT(afxServiceConfig)
 {
     afxReqWorkerFn  reqJobWorkerFn; /// Function called by the job manager when a new worker needs to be requested. When null, all jobs will be executed on the same thread that calls DoService().
     afxUnit         maxActiveWorkers; /// The maximum number of concurrent workers that will be requested. Must be >= 1 for each job type.
-    afxUnit         memSlabCnt; /// Number of memory slabs to pre-allocate for job manager memory. At least one slab per worker thread should be pre-allocated. Default is 1.
+    afxUnit         memSlabCnt; /// Number of memory slabs to pre-allocate for job manager memory. At least one slab per worker thread should be pre-allocated. Default is 1. More are allocated on demand.
     afxUnit         memSlabSiz; /// Size of each memory slab used for job manager memory. Must be a power of two. Default is 8K.
     void*           udd; /// Arbitrary data that will be passed back to the client when calling afxReqWorkerFn.
+    afxUnit         dequeCap; /// Initial capacity of each worker deque. Must be a power of two. Default is 1024; deques grow when full.
+    afxUnit         fiberCnt; /// Number of pooled fibers jobs run on, letting waiting jobs suspend instead of blocking their worker (see afxFiber). If zero, jobs run directly on worker threads.
+    afxUnit         fiberStackSiz; /// Stack size of each pooled fiber. Default is AFX_FIBER_DEF_STACK_SIZ.
+    afxUnit         injectionCap; /// Capacity of each injection queue. Must be a power of two. Default is 4096.
+};
+
+#ifdef _AFX_CORE_C
+#ifdef _AFX_SERVICE_C
+AFX_DEFINE_STRUCT(afxJobDeque)
+{
+    afxAtom64 AFX_ALIGN(AFX_CACHE_LINE_SIZ) top; // stolen from by thieves.
+    afxAtom64 AFX_ALIGN(AFX_CACHE_LINE_SIZ) bottom; // pushed and popped by the owner.
+    afxAtomPtr      ring; // afxJob*[cap]; replaced, never freed while the service lives, when growing.
+    afxUnit         cap;
+};
+
+AFX_DEFINE_STRUCT(afxJobSlab)
+// Header at the start of each job storage slab; jobs follow it.
+{
+    afxJobSlab*     next; // in the free slab list.
+    afxJobSlab*     nextAll;
+    afxAtom32       liveJobCnt; // jobs carved from this slab and not completed yet, plus one while it is the current slab of a worker.
 };
 
+AFX_DEFINE_STRUCT_ALIGNED(16, afxJobSlabList)
+// Lock-free slab stack head; exchanged whole by a double-width CAS, as afxConcurrentSlabList is.
+{
+    afxJobSlab*     first;
+    afxSize         tag; // bumped on every exchange.
+};
+
+AFX_DEFINE_STRUCT(afxJobWorker)
+{
+    afxJobDeque     deque;
+    afxUnit32       tid;
+    afxJobType      typ;
+    afxJobSlab*     slab; // current job storage slab.
+    afxUnit         slabOff;
+    afxUnit         stealSeed; // xorshift state for victim selection.
+    afxFiber*       currFiber; // fiber running the current job; NIL when fibers are disabled.
+};
+
+AFX_OBJECT(afxService)
+{
+    afxServiceConfig    cfg;
+    afxUnit             workerCnt;
+    afxJobWorker*       workers;
+    afxInterlockedQueue injection[afxJobType_TOTAL]; // jobs submitted from outside the workers.
+    afxJobSlabList      freeSlabs; // LIFO chained through afxJobSlab::next.
+    afxAtomPtr          allSlabs; // afxJobSlab* chained through afxJobSlab::nextAll, pre-allocated and grown alike; freed with the service.
+    afxAtom32           pendingCnt[afxJobType_TOTAL];
+    afxAtom32           activeWorkerCnt[afxJobType_TOTAL];
+    afxFiber*           fibers;
+    afxInterlockedQueue idleFibers; // afxFiber*
+    afxInterlockedQueue resumedFibers; // afxFiber* unparked and waiting for a worker.
+};
+#endif//_AFX_SERVICE_C
+#endif//_AFX_CORE_C
+
+/// Allocates a job from the slab of the calling worker (or from a shared slab, for non-workers). The job is released by the service after completion.
+/// If parent is not NIL, its unfinished count is incremented, so it completes only after this job.
+/// Returns NIL only if a new slab was needed and the MMU failed to provide it. Callers inside Qwadro handle it by running the work inline: 
+/// AfxParallelFor() and AfxParallelReduce() run the chunks they could not submit on the calling thread, _AfxConstructObjectRun() constructs 
+/// the rest of the batch serially, and AfxRealizeFileSegmentsAsync() realizes the remaining segments synchronously before returning.
+AFX afxJob*         AfxAllocateJob(afxService svc, afxJobType typ, afxJobFn fn, void* udd, afxJob* parent);
+
+/// Makes jobs runnable, or holds each one on its dependency counter until it reaches zero.
+/// Workers push into their own deque, which grows, so they never find it full. A non-worker which finds the injection queue full runs ready jobs itself,
+/// as AfxWaitForJobCounter() does, until the queue has room, and yields when there is none to run; jobs are never dropped and no error is raised for it.
+AFX afxError        AfxSubmitJobs(afxService svc, afxUnit cnt, afxJob* jobs[]);
+
+/// Prepares a counter to be decremented by cnt jobs.
+AFXINL void         AfxResetJobCounter(afxJobCounter* ctr, afxUnit cnt);
+
+/// Waits for a counter to reach zero. The caller runs ready jobs meanwhile instead of blocking.
+/// timeout is in microseconds; AFX_TIME_INFINITE waits indefinitely. Returns afxError_TIMEOUT if the counter did not reach zero in time.
+AFX afxError        AfxWaitForJobCounter(afxService svc, afxJobCounter* ctr, afxTime timeout);
+
+/// PARALLEL LOOPS
+/// The index range is split into grain-sized chunks which run as afxJobType_GENERAL jobs; the caller runs chunks too until the loop completes.
+/// If svc is NIL, the system service is used. If grain is zero, it is chosen from cnt and the number of workers, 
+/// except with afxParallelFlag_DETERMINISTIC, where it is chosen from cnt alone.
+/// Chunks run in any order unless afxParallelFlag_DETERMINISTIC is specified, in which case chunk boundaries do not depend on the worker count 
+/// and reduction partials are combined in index order, so results are bit-identical from run to run.
+/// The parallel invocations over pools, chains, classes and bodies share the (grain, flags) parameters and these rules.
+
+/// Invokes f for each chunk [first, first + cnt) of the range.
+AFX afxError        AfxParallelFor(afxService svc, afxUnit first, afxUnit cnt, afxUnit grain, afxParallelFlags flags, void(*f)(afxUnit first, afxUnit cnt, void* udd), void* udd);
+
+/// Invokes f for each chunk, accumulating into a partial of partialSiz bytes initialized from identity, then folds partials into result with combine.
+/// combine must be associative; it also needs to be commutative unless afxParallelFlag_DETERMINISTIC is specified.
+AFX afxError        AfxParallelReduce(afxService svc, afxUnit first, afxUnit cnt, afxUnit grain, afxParallelFlags flags, afxUnit partialSiz, void const* identity, void(*f)(afxUnit first, afxUnit cnt, void* partial, void* udd), void(*combine)(void* acc, void const* partial, void* udd), void* udd, void* result);
+
+/// Lets the calling thread help drain the queues of the service.
+/// Runs jobs for up to timeout microseconds (checked after each job completes), or, if timeout is zero, until no job is ready to run.
 AFX afxError        AfxDoService(afxService svc, afxTime timeout);
 
 ////////////////////////////////////////////////////////////////////////////////
 
 AFX afxError        AfxAcquireServices(afxUnit cnt, afxServiceConfig const config[], afxService services[]);
 
+/// Gets the service shared by the system into service. Returns FALSE, setting service to NIL, before boot up.
+AFX afxBool         AfxGetSystemService(afxService* service);
+
 #endif//AFX_SERVICE_H
@@ -32,9 +32,34 @@
     if the reader threads run continuously but write operations are rare.
 */
 
-typedef struct { void *srwl; afxUnit32 tidEx; } afxSlock;
+/**
+    A reader-biased slock lets readers enter by incrementing the counter of their slot, which only threads mapped to the same slot share,
+    while a writer raises an intent flag, then waits for every slot to drain. The slot is chosen by thread id (tid % AFX_SLOCK_READER_SLOT_CNT), 
+    not by CPU, so a reader migrating between entry and exit still decrements the slot it incremented. It suits locks which are read far more often 
+    than written, such as the class pool lock and the MMU chain, at the cost of costlier exclusive entry.
+    Both kinds spin briefly before parking.
+*/
+
+#define AFX_SLOCK_READER_SLOT_CNT 64
+
+typedef enum afxSlockFlag
+{
+    afxSlockFlag_READER_BIASED  = AFX_BIT(0),
+    afxSlockFlag_INSTRUMENTED   = AFX_BIT(1), // count contention; see AfxDescribeSlockContention().
+} afxSlockFlags;
+
+typedef struct
+{
+    void *srwl;
+    afxUnit32 tidEx;
+    afxSlockFlags flags;
+    afxAtom32* readerSlots; // AFX_SLOCK_READER_SLOT_CNT counters, each on its own cache line; reader-biased only.
+    afxAtom32 writerIntent;
+    afxLockStats* stats; // instrumented only.
+} afxSlock;
 
 AFX afxError AfxDeploySlock(afxSlock *slck);
+AFX afxError AfxDeploySlock2(afxSlock *slck, afxSlockFlags flags);
 AFX afxError AfxDismantleSlock(afxSlock *slck);
 
 AFX void    AfxEnterSlockShared(afxSlock *slck);
@@ -46,4 +71,7 @@ AFX void    AfxExitSlockExclusive(afxSlock *slck);
 AFX afxBool AfxTryEnterSlockShared(afxSlock *slck);
 AFX afxBool AfxTryEnterSlockExclusive(afxSlock *slck);
 
+/// Returns FALSE if the slock is not instrumented. Shared and exclusive entries are summed.
+AFX afxBool AfxDescribeSlockContention(afxSlock *slck, afxLockStats* stats);
+
 #endif//AFX_SLOCK_H
@@ -60,6 +60,37 @@ enum // opcodes used for primitive communication bethween engine and executables
     AFX_OPCODE_ATTACH, // informa a um mdulo que ele ser acoplado ao sistema, dando-lhe uma chance de realizar sua devida initializao de recursos e operaes.
 };
 
+AFX_DEFINE_STRUCT(afxCpuInfo)
+/// Describes a logical processor.
+{
+    afxUnit                 coreIdx; // physical core; logical processors sharing it are SMT siblings.
+    afxUnit                 packageIdx;
+    afxUnit                 numaNode;
+    afxUnit                 l2GroupIdx; // logical processors with the same index share a L2 cache.
+    afxUnit                 l3GroupIdx; // logical processors with the same index share a L3 cache.
+    afxBool                 efficient; // belongs to a efficiency (little) core class.
+};
+
+AFX_DEFINE_STRUCT(afxCpuTopology)
+{
+    afxUnit                 cpuCnt; // logical processors.
+    afxUnit                 coreCnt;
+    afxUnit                 packageCnt;
+    afxUnit                 numaNodeCnt;
+    afxUnit                 cacheLineSiz;
+    afxUnit                 l1dSiz; // per core.
+    afxUnit                 l2Siz; // per L2 group.
+    afxUnit                 l3Siz; // per L3 group.
+};
+
+AFX_DEFINE_STRUCT(afxThreadPlacement)
+/// Default placement of threads of a purpose.
+{
+    afxCpuSet               affinity; // empty means any processor.
+    afxThreadPriority       priority;
+    afxBool                 exclusive; // threads of other purposes avoid the processors in affinity.
+};
+
 AFX_DEFINE_STRUCT(afxPlatformConfig)
 {
     afxFcc                  platFcc;
@@ -85,10 +116,12 @@ AFX_DEFINE_STRUCT(afxSystemConfig)
     afxUnit                 memPageSiz;
     afxUnit                 allocGranularity;
     afxUnit                 genrlArenaSpace;
+    afxUnit                 frameArenaSpace; // chunk size of each per-thread frame arena backing TEMPORARY and TRANSIENT allocations.
 
     afxUnit                 ioBufSiz;
     afxUnit                 ioArenaSpace;
     afxUnit                 hwThreadingCap; // max amount of hardware threads managed by Qwadro.
+    afxThreadPlacement      threadPlacements[afxThreadPurpose_TOTAL]; // indexed by afxThreadPurpose. AfxConfigureSystem() dedicates a physical core, SMT sibling excluded, to SOUND.
     afxReal                 unitsToMeter; // the number of units in a meter.
     
     afxAssertHook           assertHook; // external assertion handling function (optional)
@@ -131,6 +164,14 @@ AFX afxUnit             AfxGetMemoryPageSize(void);
 /// This function returns 1 if neither value could be determined.
 AFX afxUnit             AfxGetThreadingCapacity(void);
 
+/// Describes the processor topology discovered at boot up. Logical processors beyond AFX_MAX_CPU_CNT are not managed.
+AFX void                AfxDescribeCpuTopology(afxCpuTopology* topology);
+
+AFX afxUnit             AfxDescribeCpus(afxUnit first, afxUnit cnt, afxCpuInfo infos[]);
+
+/// Fills a set with the logical processors of a NUMA node, or with one logical processor per physical core (SMT siblings excluded) if numaNode is AFX_INVALID_INDEX.
+AFX void                AfxGetCpuSet(afxUnit numaNode, afxCpuSet* set);
+
 AFX afxUri const*       AfxGetSystemDirectory(afxUri *dst);
 AFX afxString const*    AfxGetSystemDirectoryString(afxString *dst);
 
@@ -142,6 +183,7 @@ AFX afxUnit32           AfxGetPrimeTid(void);
 // Sends event event directly to receiver receiver, using the notify() function. Returns the value that was returned from the event handler.
 // Adds the event event, with the object receiver as the receiver of the event, to an event queue and returns immediately.
 
+/// Events are queued into the inbox of the thread owning receiver (see AfxPostEvent()).
 AFX afxBool             AfxEmitEvent(afxObject receiver, afxEvent* ev);
 
 AFX afxUnit              AfxCountDevices(afxDeviceType type);
@@ -31,8 +31,74 @@
 #include "qwadro/inc/mem/afxQueue.h"
 #include "qwadro/inc/base/afxEvent.h"
 #include "qwadro/inc/exec/afxAtomic.h"
+#include "qwadro/inc/exec/afxSlock.h"
+#include "qwadro/inc/mem/afxInterlockedQueue.h"
+#include "qwadro/inc/mem/afxArena.h"
 
 #define AFX_THR_MIN_EVENT_CAP 32
+#define AFX_THR_EVENT_INLINE_SIZ 64 // payload bytes an inbox slot holds; larger events always spill.
+#define AFX_THR_COALESCE_SLOT_CNT 16
+#define AFX_THR_SPILL_CHUNK_SIZ 16384 // events larger than a chunk get a chunk of their own.
+
+/**
+    EVENT INBOX
+    Each thread receives posted events in a MPSC inbox: a bounded ring of minEventCap slots claimed without locks by producers.
+    When the ring is full, or an event does not fit a slot, it spills into spill storage of the inbox and is chained in a lock-free 
+    overflow list, so posting never takes a lock of the inbox, never waits on the owner and never drops.
+    Spill storage is a chain of chunks carved by an atomic bump of the offset of the current chunk; a producer overrunning it installs 
+    a new chunk by CAS (a loser returns its own to the MMU), retiring the old one. Each spilling producer counts itself in spillerCnt from 
+    before it loads the current chunk until its event is linked into the overflow list. Retired chunks are freed by the owner only once 
+    the overflow list is empty and spillerCnt was seen zero after their retirement, so no payload is freed while a producer may still write it.
+    Once an event spilled, every later post also goes to the overflow list until a drain empties it, so a ring slot never overtakes a spilled event;
+    events from one producer are thus delivered in the order it posted them. Posts racing from distinct producers have no defined order.
+    Coalescible events (posted with afxPostFlag_COALESCE) with the same receiver and id share a slot of a small table, indexed by a hash of both.
+    The slot stores the receiver and the event id themselves, and a post coalesces only if both compare equal under the sequence lock; 
+    a later post then overwrites the pending payload, so only the last one is delivered, at the position of the first post.
+    A post finding the slot pending with another receiver or id, or carrying more than AFX_THR_EVENT_INLINE_SIZ bytes, 
+    is not coalesced: it takes the regular path (ring or spill), so no event is ever merged into a different one nor lost.
+    The owner thread drains the inbox in batches at each iteration of its loop.
+*/
+
+typedef enum afxPostFlag
+{
+    afxPostFlag_COALESCE    = AFX_BIT(0), // keep only the last pending event with the same receiver and id (e.g. mouse moves, resizes).
+} afxPostFlags;
+
+#ifdef _AFX_CORE_C
+#ifdef _AFX_THREAD_C
+AFX_DEFINE_STRUCT(afxEventCoalesceSlot)
+{
+    afxAtom32       seq; // odd while being written.
+    afxAtom32       pending; // a marker for this slot is queued.
+    afxObject       receiver; // with id, identifies the pending event; written while seq is odd.
+    afxEventId      id;
+    afxByte         payload[AFX_THR_EVENT_INLINE_SIZ];
+};
+
+AFX_DEFINE_STRUCT(afxEventSpillChunk)
+{
+    afxEventSpillChunk*     next; // chained in retiredChunks.
+    afxAtom32               offset; // bumped by producers; may overrun siz, in which case the chunk is full.
+    afxUnit                 siz;
+    afxByte AFX_ADDR        data[];
+};
+
+AFX_DEFINE_STRUCT(afxEventInbox)
+{
+    afxInterlockedQueue     ring; // afxPostedEvent headers plus AFX_THR_EVENT_INLINE_SIZ payload bytes.
+    afxAtomPtr AFX_ALIGN(AFX_CACHE_LINE_SIZ) overflowHead; // afxPostedEvent*, pushed by producers.
+    afxPostedEvent*         overflowTail; // owned by the consumer.
+    afxAtom32               spilling; // set by the first spill; later posts bypass the ring until a drain empties the overflow list.
+    afxAtomPtr AFX_ALIGN(AFX_CACHE_LINE_SIZ) spillChunk; // afxEventSpillChunk* currently carved.
+    afxAtom32               spillerCnt; // producers between loading spillChunk and linking their event.
+    afxAtomPtr              retiredChunks; // replaced chunks waiting to be freed by the owner.
+    afxEventCoalesceSlot    coalesce[AFX_THR_COALESCE_SLOT_CNT];
+    afxAtom32               postedCnt;
+    afxAtom32               spilledCnt;
+    afxAtom32               coalescedCnt;
+};
+#endif//_AFX_THREAD_C
+#endif//_AFX_CORE_C
 
 typedef enum afxThreadPurpose
 {
@@ -42,9 +108,33 @@ typedef enum afxThreadPurpose
     afxThreadPurpose_ASIO,
     afxThreadPurpose_COMM,
     afxThreadPurpose_SIM,
-    afxThreadPurpose_HID
+    afxThreadPurpose_HID,
+
+    afxThreadPurpose_TOTAL
 } afxThreadPurpose;
 
+typedef enum afxThreadPriority
+{
+    afxThreadPriority_DEFAULT, // inherit the one set for the purpose in afxSystemConfig, or the OS default.
+    afxThreadPriority_IDLE,
+    afxThreadPriority_LOW,
+    afxThreadPriority_NORMAL,
+    afxThreadPriority_HIGH,
+    afxThreadPriority_CRITICAL, // time-critical, as for sound mixing. May require privileges; falls back to HIGH.
+} afxThreadPriority;
+
+#define AFX_MAX_CPU_CNT 256
+
+AFX_DEFINE_STRUCT(afxCpuSet)
+/// A set of logical processors, indexed as in AfxDescribeCpus(). An empty set means no restriction.
+{
+    afxMask64           bits[AFX_MAX_CPU_CNT / 64];
+};
+
+#define AfxAddCpuToSet(set_, cpuIdx_) ((set_)->bits[(cpuIdx_) / 64] |= ((afxMask64)1 << ((cpuIdx_) % 64)))
+#define AfxRemoveCpuFromSet(set_, cpuIdx_) ((set_)->bits[(cpuIdx_) / 64] &= ~((afxMask64)1 << ((cpuIdx_) % 64)))
+#define AfxIsCpuInSet(set_, cpuIdx_) (((set_)->bits[(cpuIdx_) / 64] >> ((cpuIdx_) % 64)) & 1)
+
 typedef afxResult(*afxThreadProc)(afxThread thr, afxEvent* ev);
 
 AFX_DEFINE_STRUCT(afxThreadConfig)
@@ -54,6 +144,9 @@ AFX_DEFINE_STRUCT(afxThreadConfig)
     //afxThreadProc       procCb;
     afxUnit             tid;
     void*               udd[4];
+    afxCpuSet           affinity; // if empty, the affinity set for the purpose in afxSystemConfig is used.
+    afxUnit             eventSpillSiz; // size of the lock-free spill chunks of the event inbox. If zero, Qwadro will use AFX_THR_SPILL_CHUNK_SIZ.
+    afxThreadPriority   priority;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -89,6 +182,13 @@ AFX afxBool     AfxIsThreadFinished(afxThread thr);
 
 AFX afxBool     AfxGetThreadExitCode(afxThread thr, afxInt* exitCode);
 
+/// Pins the thread to a set of logical processors. An empty set removes the restriction.
+AFX afxError    AfxSetThreadAffinity(afxThread thr, afxCpuSet const* affinity);
+AFX void        AfxGetThreadAffinity(afxThread thr, afxCpuSet* affinity);
+
+AFX afxError    AfxSetThreadPriority(afxThread thr, afxThreadPriority priority);
+AFX afxThreadPriority AfxGetThreadPriority(afxThread thr);
+
 /// Blocks the thread until the thread associated with this afxThread object has finished execution (i.e. when it returns from run()). 
 /// This function will return true if the thread has finished. It also returns true if the thread has not been started yet.
 
@@ -101,6 +201,18 @@ AFX void        AfxGetThreadTime(afxReal64* ct, afxReal64* dt);
 AFX void        AfxGetThreadClock(afxClock* curr, afxClock* last);
 AFX void        AfxGetThreadFrequency(afxUnit* iterNo, afxUnit* lastFreq);
 
+////////////////////////////////////////////////////////////////////////////////
+/// Each thread records the duration of every iteration of its loop into a pair of afxTimingHistogram, swapped every AFX_THR_TIMING_WINDOW iterations.
+/// Statistics are computed over the current and the previous window, so they roll without ever being empty after the first window.
+
+#define AFX_THR_TIMING_WINDOW 1024
+
+/// Reads the rolling loop timing statistics of a thread. Safe to call from any thread; counts may be torn by at most the iteration in progress.
+AFX afxError    AfxGetThreadTiming(afxThread thr, afxTimingStats* stats);
+
+/// Writes a table of the rolling loop timing statistics of every thread, by tid and purpose, to the stream.
+AFX afxError    AfxDumpThreadTimings(afxStream out);
+
 /// Test if the currently executing thread is the prime thread; the one which bootstrapped the Qwadro.
 AFX afxBool     AfxIsPrimeThread(void);
 
@@ -124,12 +236,77 @@ AFX void        AfxExitThread(afxInt code);
 
 AFX void        AfxQuitThread(void);
 
+/// Posts an event to the inbox of the thread tid, to be delivered to receiver by that thread. Lock-free; never waits, even when spilling.
+AFX afxError    AfxPostEvent(afxUnit32 tid, afxObject receiver, afxEvent const* ev, afxPostFlags flags);
+
+/// Posts cnt events claiming the ring slots together. receivers and events are parallel arrays.
+AFX afxUnit     AfxPostEvents(afxUnit32 tid, afxUnit cnt, afxObject const receivers[], afxEvent const* events[], afxPostFlags flags);
+
+/// Delivers up to maxCnt events from the inbox of the calling thread, or all of them if maxCnt is zero. Returns how many were delivered.
+/// Called by the thread event loop; threads running their own loops must call it.
+AFX afxUnit     AfxDrainThreadEvents(afxUnit maxCnt);
+
 /// Yields execution of the current thread to another runnable thread, if any. 
 /// Note that the operating system decides to which thread to switch.
 AFX void        AfxYield(void);
 
 AFX void        AfxSleep(afxUnit ms);
 
+////////////////////////////////////////////////////////////////////////////////
+/// FIBERS
+/// A afxFiber is a user-mode execution context with its own stack, switched cooperatively on the thread running it.
+/// Workers of a afxService configured with fibers run jobs on pooled fibers. When such a job waits, 
+/// on a semaphore (AfxWaitForSemaphores), on another job (AfxWaitForJobCounter) or on a stream read submitted through a afxIoBridge, 
+/// its fiber is parked and the worker switches to another job; the fiber is resumed by whichever worker picks it up after the wait is satisfied.
+/// Outside of fibers, the same waits block the OS thread as usual.
+/// Since a parked job may resume on another thread, per-thread state a job relies on across a wait lives in its fiber instead:
+/// while a fiber runs, AfxGetFrameArena(afxMemFlag_TEMPORARY) and the AfxPushMemoryOwner() scopes resolve to those of the fiber, 
+/// whose TEMPORARY arenas advance at the boundaries of the jobs it runs rather than at those of the hosting thread.
+/// TRANSIENT frame units stay per thread; a job must not hold them across a wait, and debug builds assert that none was requested before parking.
+/// No lock may be held across a wait which can park: afxSlock picks its reader slot and records exclusive owners (tidEx) by thread id, 
+/// and OS mutexes and SRW locks are bound to the thread which locked them, so a fiber resuming on another worker would release them on the wrong thread.
+/// Entering and leaving afxSlock and afxMutex adjust heldLockCnt of the running fiber, and AfxParkFiber() asserts in debug builds that it is zero.
+
+#define AFX_FIBER_DEF_STACK_SIZ 65536
+#define AFX_FIBER_OWNER_DEPTH 8 // nesting depth of AfxPushMemoryOwner() scopes kept by a fiber.
+
+AFX_DEFINE_STRUCT(afxFiber)
+{
+    void*           ctx; // OS fiber or saved register context.
+    void*           stack;
+    afxUnit         stackSiz;
+    void            (*proc)(afxFiber* fib, void* udd);
+    void*           udd;
+    afxAtom32*      parkWord; // word the fiber is parked on; NIL if runnable.
+    afxInt32        parkVal;
+    afxFiber*       next; // chained in a park list or in a ready queue.
+    afxArena        temporary[2]; // TEMPORARY frame arena pair of the jobs run on this fiber; see AfxAdvanceFrameArenas().
+    afxUnit         temporaryIdx; // current arena of the pair.
+    afxUnit         jobDepth; // jobs running nested on this fiber; TEMPORARY is only advanced when it returns to zero.
+    afxUnit         heldLockCnt; // afxSlock and afxMutex entries held by the job running on this fiber; must be zero to park.
+    afxClass*       owners[AFX_FIBER_OWNER_DEPTH]; // AfxPushMemoryOwner() scopes opened on this fiber.
+    afxUnit         ownerDepth;
+};
+
+/// Turns the calling thread into a fiber host, which is required before switching to fibers. Idempotent.
+AFX afxError    AfxEnterFiberMode(void);
+
+AFX afxError    AfxDeployFiber(afxFiber* fib, afxUnit stackSiz, void(*proc)(afxFiber* fib, void* udd), void* udd);
+AFX void        AfxDismantleFiber(afxFiber* fib);
+
+AFX void        AfxSwitchToFiber(afxFiber* fib);
+
+/// Returns the fiber running on the calling thread; NIL if the thread is not running a fiber.
+AFX afxFiber*   AfxGetCurrentFiber(void);
+
+/// Parks the current fiber while *word equals val, handing the thread back to its scheduler. Returns at once if *word differs.
+/// The fiber must hold no lock (see heldLockCnt); debug builds assert it.
+/// Called on a thread not running a fiber, it waits on the word as a futex instead. This is the hook waits are built upon.
+AFX void        AfxParkFiber(afxAtom32* word, afxInt32 val);
+
+/// Makes runnable up to cnt fibers (or threads) parked on word. Returns how many were woken.
+AFX afxUnit     AfxUnparkFibers(afxAtom32* word, afxUnit cnt);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /// Returns a afxThread handle which manages the currently executing thread.
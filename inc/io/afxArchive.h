@@ -44,13 +44,59 @@ AFX_DEFINE_STRUCT(afxArchiveItemDescriptor)
     afxUnit32    crc32;
 };
 
+/**
+    CENTRAL DIRECTORY INDEX
+
+    On open, afxArchive hashes the case-folded path of each central directory entry into an open-addressing table,
+    so AfxFindArchivedFile() is a probe instead of a linear search of the directory.
+    The table may be saved with AfxSaveArchiveIndex() and given back to AfxOpenArchive2(); it is used only if its magic and version 
+    are known and its stamp matches the central directory (offset, size, entry count and crc32 of the directory bytes), otherwise it is rebuilt.
+    The saved layout uses fixed-width, little-endian fields only, so 32- and 64-bit builds share index files.
+    The hash is part of the format: 32-bit FNV-1a over the path bytes as stored in the directory, after case folding, where case folding 
+    maps ASCII 'A'-'Z' to 'a'-'z' and '\\' to '/', leaving every other byte (UTF-8 sequences included) unchanged. A hash of 0 is stored as 1, 
+    since 0 marks an empty slot. Probing is linear, starting at slot (hash & (slotCnt - 1)). Changing any of these rules requires bumping AFX_ARCHIVE_INDEX_VERSION.
+    When paths differ only in case, AfxFindArchivedFile() prefers the entry whose path matches exactly; 
+    failing that, the one appearing first in the central directory wins.
+*/
+
+#define AFX_ARCHIVE_INDEX_MAGIC     AFX_MAKE_FCC('a', 'x', 'i', 'x')
+#define AFX_ARCHIVE_INDEX_VERSION   1
+
+AFX_DEFINE_STRUCT(afxArchiveIndexStamp)
+{
+    afxUnit32   magic; // AFX_ARCHIVE_INDEX_MAGIC
+    afxUnit32   version; // AFX_ARCHIVE_INDEX_VERSION
+    afxUnit64   cdOffset; // offset of the central directory.
+    afxUnit32   cdSize; // size of the central directory.
+    afxUnit32   cdCrc32; // crc32 of the central directory bytes.
+    afxUnit32   entryCnt;
+    afxUnit32   slotCnt; // power of two.
+};
+
+AFX_DEFINE_STRUCT(afxArchiveIndexSlot)
+{
+    afxUnit32   hash; // FNV-1a of the case-folded path, remapped from 0 to 1; 0 marks an empty slot.
+    afxUnit32   idx; // entry index.
+};
+
+AFX_DEFINE_STRUCT(afxArchiveExtraction)
+// Describes one entry of a batch extraction. Either dst or out is given.
+{
+    afxUnit     idx; // entry index.
+    void*       dst; // caller buffer receiving the uncompressed data.
+    afxUnit     dstSiz; // must be at least the uncompressed size of the entry.
+    afxStream   out; // stream receiving the uncompressed data, at its current position.
+    afxBool     verify; // check the crc32 of the uncompressed data.
+    afxError    result; // set on completion.
+};
+
 AFX afxUnit     AfxCountArchivedFiles(afxArchive arc);
 
 AFX afxBool     AfxArchivedFileIsDirectory(afxArchive arc, afxUnit idx);
 AFX afxError    AfxDumpArchivedFile(afxArchive arc, afxUnit idx, afxUnit bufSiz, void *buf);
 AFX afxError    AfxForkArchivedFile(afxArchive arc, afxUnit idx, afxStream *ios);
 AFX afxError    AfxExtractArchivedFile(afxArchive arc, afxUnit idx, afxUri const *uri); // extract to file directory.
-AFX afxBool     AfxFindArchivedFile(afxArchive arc, afxUri const *name, afxUnit *idx);
+AFX afxBool     AfxFindArchivedFile(afxArchive arc, afxUri const *name, afxUnit *idx); // case-insensitive, exact case preferred; uses the index.
 AFX afxError    AfxOpenArchivedFile(afxArchive arc, afxUnit idx, afxStream *in);
 
 AFX afxError    AfxDescribeArchivedFile(afxArchive arc, afxUnit idx, afxArchiveItemDescriptor *desc);
@@ -60,8 +106,27 @@ AFX afxUnit     AfxGetArchivedFileUncompressedSize(afxArchive arc, afxUnit idx);
 AFX afxString*  AfxGetArchivedFileName(afxArchive arc, afxUnit idx, afxUri *name);
 AFX afxUnit32   AfxGetArchivedFileCrc(afxArchive arc, afxUnit idx);
 
+/**
+    The AfxExtractArchivedFiles() method inflates many entries concurrently on the workers of a service.
+
+    Each entry is read by a afxJobType_BLOCKING job and inflated and, if requested, checked against its crc32 by a afxJobType_GENERAL job, 
+    so reads overlap with inflation. Results are reported per entry in its afxArchiveExtraction::result.
+    Entries writing to the same afxStream are serialized in the order they are given.
+    fence is reset to cnt and decremented as each entry completes; if fence is NIL, the call waits for all entries.
+
+    @param svc is the service to run on; NIL for the system service.
+*/
+
+AFX afxError    AfxExtractArchivedFiles(afxArchive arc, afxUnit cnt, afxArchiveExtraction ops[], afxService svc, afxJobCounter* fence);
+
+/// Writes the central directory index, stamped with the directory it was built from.
+AFX afxError    AfxSaveArchiveIndex(afxArchive arc, afxUri const* uri);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 AFX afxArchive  AfxOpenArchive(afxUri const* uri, afxFileFlags const flags, afxError* err);
 
+/// As AfxOpenArchive(), loading the central directory index from idxUri if it is present and its stamp matches.
+AFX afxArchive  AfxOpenArchive2(afxUri const* uri, afxFileFlags const flags, afxUri const* idxUri, afxError* err);
+
 #endif//AFX_ARCHIVE_H
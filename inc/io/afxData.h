@@ -25,31 +25,93 @@ typedef enum afxCompressionType
 {
     //NONE // no compressed
     AFX_COMPRESSION_TYPE_RLE = 1,
+    AFX_COMPRESSION_TYPE_LZ4,
+    AFX_COMPRESSION_TYPE_LZ4F,
+    AFX_COMPRESSION_TYPE_ZSTD,
 } afxCompressionType;
 
+/// Codec identifiers stored in afxFileSegment::codec and urdSegment::codec. Each one also has a codec fcc (afxFcc_RAW, etc) 
+/// accepted wherever a afxFcc codec is expected (AfxDecodeStream2(), AfxCmdDecode(), etc); see AfxGetCodecFcc().
 typedef enum afxCodecId
 {
     afxCodecId_RAW,
     afxCodecId_RLE,
+    afxCodecId_LZ4, // LZ4 block; decSiz must be known to decode.
+    afxCodecId_LZ4F, // LZ4 frame, with content size and checksum.
+    afxCodecId_ZSTD, // Zstandard frame; optionally against a trained dictionary identified in the frame header.
+
+    afxCodecId_TOTAL
 } afxCodecId;
 
+AFX_DEFINE_STRUCT(afxCodecConfig)
+{
+    afxFcc          codec; // afxFcc_LZ4, afxFcc_ZSTD, etc.
+    afxInt          level; // compression level; zero for the codec default. Negative levels select LZ4 acceleration or Zstandard fast levels.
+    void const*     dict; // Zstandard only; a trained dictionary. NIL for none. Register it too (AfxRegisterCodecDictionary()) so shared codecs can decode its frames.
+    afxUnit         dictSiz;
+};
+
 #ifdef _AFX_CORE_C
 #ifdef _AFX_CODEC_C
 AFX_OBJECT(afxCodec)
 {
     afxError(*enc)(afxStream stream, afxUnit len, afxUnit byteCnt, afxByte const* src);
     afxError(*dec)(afxStream stream, afxUnit len, afxUnit byteCnt, afxByte* dst);
+    afxError(*encBlock)(afxCodec cdc, void const* src, afxUnit srcLen, void* dst, afxUnit dstCap, afxUnit* encLen);
+    afxError(*decBlock)(afxCodec cdc, void const* src, afxUnit srcLen, void* dst, afxUnit dstLen);
+    afxFcc          fcc;
+    afxInt          level;
+    void*           ctx; // reusable (de)compression context; one per thread is kept by the system for shared codecs.
+    void*           dict; // digested dictionary, if any.
+    afxUnit32       dictId;
 };
 #endif//_AFX_CODEC_C
 #endif//_AFX_CORE_C
 
 AFX afxUnit  AfxGetCompressionPaddingSize(afxCompressionType type);
 
+/// stop0, stop1 and stop2 are offsets into the decompressed bytes; their meaning depends on type:
+/// RLE: the ends of the three successive stages of the stream, as written by the encoder.
+/// LZ4 (block): the block stores no size, so stop2 must be the exact decoded size; stop0 and stop1 are ignored.
+/// LZ4F and ZSTD: frames carry their content size; stop2 is the capacity of decompressedBytes, and decoding fails if the frame 
+/// does not decode to exactly stop2 bytes. stop0 and stop1 are ignored. ZSTD frames referencing a dictionary are decoded against 
+/// the one registered under its dictId (see AfxRegisterCodecDictionary()).
 AFX afxBool AfxDecompressData(afxCompressionType type, afxBool fileIsByteReversed, afxUnit compressedBytesSiz, void *compressedBytes, afxInt stop0, afxInt stop1, afxInt stop2, void *decompressedBytes);
 
 AFX afxError    AfxEncode(afxCodec cdc, void const* src, afxUnit srcLen, void* dst, afxUnit dstLen);
 AFX afxError    AfxDecode(afxCodec cdc, void const* src, afxUnit srcLen, void* dst, afxUnit dstLen);
 
+/// Same as AfxEncode(), returning the encoded length. dstCap should be at least AfxGetCodecBound(cdc, srcLen).
+AFX afxError    AfxEncode2(afxCodec cdc, void const* src, afxUnit srcLen, void* dst, afxUnit dstCap, afxUnit* encLen);
+
+/// Returns the worst-case encoded size of srcLen bytes.
+AFX afxUnit     AfxGetCodecBound(afxCodec cdc, afxUnit srcLen);
+
+AFX afxFcc      AfxGetCodecFcc(afxCodecId id);
+AFX afxCodecId  AfxGetCodecId(afxFcc fcc);
+
+/// Returns the shared codec for a fcc, with default level and no dictionary of its own; NIL if the codec is not supported.
+/// When decoding a Zstandard frame whose header names a dictId, the shared codec uses the dictionary registered under that id, 
+/// so AfxDecodeStream2(), AfxCmdDecode() and file segment reads decode dictionary-trained frames; it fails with afxError_NOT_FOUND if none is registered.
+AFX afxCodec    AfxGetCodec(afxFcc fcc);
+
+/// Trains a Zstandard dictionary of up to dictCap bytes from cnt samples. Returns the dictionary size, or zero on failure.
+AFX afxUnit     AfxTrainCodecDictionary(afxUnit cnt, void const* const samples[], afxUnit const sampleSizes[], afxUnit dictCap, void* dict);
+
+/// DICTIONARY REGISTRY
+/// The system keeps Zstandard dictionaries keyed by the dictId stored in their header (and in the frames encoded with them), digested once on registration.
+/// Registration is reference counted, so unrelated modules may register the same dictionary; lookups on decode take no lock.
+
+/// Registers a trained dictionary, copying it. Sets dictId, if not NIL, to its id. Fails with afxError_INVALID if dict has no dictId (raw content dictionaries).
+AFX afxError    AfxRegisterCodecDictionary(void const* dict, afxUnit dictSiz, afxUnit32* dictId);
+
+/// Drops a reference to the dictionary registered under dictId; it is freed once unreferenced and no decode is using it.
+AFX void        AfxUnregisterCodecDictionary(afxUnit32 dictId);
+
+////////////////////////////////////////////////////////////////////////////////
+
+AFX afxError    AfxAcquireCodecs(afxUnit cnt, afxCodecConfig const cfg[], afxCodec codecs[]);
+
 //AFX void        AfxDecodeStream(afxStream stream, afxUnit len, afxUnit byteCnt, afxByte *dst);
 
 #endif//AFX_DATA_H
@@ -25,6 +25,7 @@
 
 #include "qwadro/inc/io/afxStream.h"
 #include "qwadro/inc/io/afxUri.h"
+#include "qwadro/inc/exec/afxService.h"
 
 typedef enum afxFileFlag
 {
@@ -51,8 +52,18 @@ typedef enum afxFileFlag
     afxFileFlag_E       = AFX_BIT(12), // Encrypted. The data is encrypted. For a file, all data streams in the file are encrypted. This is used by SIGMA Future Storage.
     afxFileFlag_O       = AFX_BIT(13), // Offline. The data isn't available immediately. This flag indicates that the data is physically moved to remote/offline storage. This is used by SIGMA Future Storage.
     afxFileFlag_S       = AFX_BIT(14), // Sparse. The data is a sparse file. Empty ranges (zeroed ranges) are generated dynamically by some algorithm. This is used by SIGMA Future Storage.
+    afxFileFlag_M       = AFX_BIT(15), // Mapped. The data is a private, copy-on-write memory mapping of the file instead of a copy in RAM. See AfxLoadFile2().
 } afxFileFlags;
 
+typedef enum afxFileAdvice
+{
+    afxFileAdvice_NORMAL,
+    afxFileAdvice_SEQUENTIAL, // pages will be touched in order; read ahead aggressively and drop behind.
+    afxFileAdvice_RANDOM, // disable read ahead.
+    afxFileAdvice_WILLNEED, // start paging the range in now.
+    afxFileAdvice_DONTNEED, // the range will not be touched soon; its pages may be dropped.
+} afxFileAdvice;
+
 #pragma pack(push, 1)
 
 AFX_DEFINE_STRUCT(afxFileSegment)
@@ -61,7 +72,7 @@ AFX_DEFINE_STRUCT(afxFileSegment)
     afxUnit16   decodedAlign;
     afxUnit32   decodedSiz; // decoded/uncompressed size
     afxUnit32   encodedSiz; // encoded/compressed size
-    afxUnit32   codec; // codec used to compress this section
+    afxUnit32   codec; // codec used to compress this section; a afxCodecId.
     afxUnit32   start; // where starts the data belonging to this segment.
 };
 
@@ -93,8 +104,43 @@ AFX afxBool     AfxOpenFileSegments(afxStream file, afxUnit baseSegIdx, afxUnit
 
 AFX void        AfxCloseFileSegments(afxStream file, afxUnit baseSegIdx, afxUnit segCnt);
 
+/// Realizes segments in parallel on the system service and waits for them; see AfxRealizeFileSegmentsAsync().
 AFX afxError    AfxRealizeFileSegments(afxStream file, afxUnit32 baseSegOffset, afxUnit segCnt);
 
+/**
+    The AfxRealizeFileSegmentsAsync() method splits the realization of segments across the workers of a service.
+
+    Each segment is read by a afxJobType_BLOCKING job into a staging buffer (or taken in place, if the file is mapped) 
+    and decoded by a afxJobType_GENERAL job depending on that read, so reads of later segments overlap with decoding of earlier ones.
+    Segments are decoded directly into their final destination: dsts[i] if given (at least decodedSiz bytes, aligned to decodedAlign), 
+    otherwise a buffer allocated for the segment as AfxRealizeFileSegments() would.
+    fence is reset to segCnt and decremented as each segment completes; wait on it with AfxWaitForJobCounter().
+    If fence is NIL, the call waits for all segments and returns the first segment error, if any.
+    Otherwise, the call returns once the jobs are submitted, and the result of each segment is queried with AfxGetFileSegmentStatus() after the fence reached zero.
+    The fence always reaches zero, whatever the call returns: it is reset to segCnt before anything is submitted, and every segment 
+    which could not be submitted is either realized synchronously (when job storage can not be had) or marked failed, then counted down 
+    before the call returns. An error returned with a fence is thus only a summary; waiting on the fence never hangs.
+
+    @param svc is the service to run on; NIL for the system service.
+    @param dsts is NIL or an array of segCnt destinations, in which NIL entries request allocation.
+*/
+
+AFX afxError    AfxRealizeFileSegmentsAsync(afxStream file, afxUnit32 baseSegOffset, afxUnit segCnt, void* const dsts[], afxService svc, afxJobCounter* fence);
+
+/// Returns the result of the last realization of a segment: afxError_SUCCESS once realized, or the error of its read or decode. 
+/// The result of a segment still being realized is unspecified; wait on the fence first.
+AFX afxError    AfxGetFileSegmentStatus(afxStream file, afxUnit segIdx);
+
+/// In a mapped file, segments stored uncompressed (afxCodecId_RAW) whose start satisfies decodedAlign are not copied: 
+/// they are realized as views into the mapping, and AfxResolveFileReference() points straight into it.
+/// The mapping is private and copy-on-write (MAP_PRIVATE, FILE_MAP_COPY on Windows), so in-place fixups and byte reversal through a view 
+/// work as on a copied segment: touched pages get private copies and nothing is ever written back to the file.
+/// Each open view holds a reference on the mapping, which is only unmapped when the file is disposed and every view is closed.
+AFX afxBool     AfxIsFileSegmentMapped(afxStream file, afxUnit segIdx);
+
+/// Advises the OS about how a range of a mapped file will be touched. Does nothing on files which are not mapped.
+AFX afxError    AfxAdviseFile(afxStream file, afxSize offset, afxSize range, afxFileAdvice advice);
+
 // FILE REUSE
 
 /**
@@ -113,6 +159,9 @@ AFX afxError    AfxReopenFile(afxStream file, afxUri const* uri, afxFileFlags fl
 
 AFX afxError    AfxReloadFile(afxStream file, afxUri const* uri); // will upload the entire file data into RAM and close the file.
 
+/// Same as AfxReloadFile() but, with afxFileFlag_M, maps the file copy-on-write instead of copying it.
+AFX afxError    AfxReloadFile2(afxStream file, afxUri const* uri, afxFileFlags flags);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -127,4 +176,8 @@ AFX afxError    AfxOpenFile(afxUri const* uri, afxFileFlags flags, afxStream* fi
 
 AFX afxError    AfxLoadFile(afxUri const* uri, afxStream* file); // will upload the entire file data into RAM and close the file.
 
+/// Same as AfxLoadFile() but, with afxFileFlag_M, maps the file copy-on-write instead of copying it, so loading costs page faults on touch rather than a copy.
+/// Falls back to copying where the file can not be mapped (e.g. archived or virtual files); test afxFileFlag_M on the resulting stream to know.
+AFX afxError    AfxLoadFile2(afxUri const* uri, afxFileFlags flags, afxStream* file);
+
 #endif//AFX_FILE_H
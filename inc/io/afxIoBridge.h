@@ -23,8 +23,39 @@
 typedef enum afxIoPortFlag
 {
     afxIoPortFlag_      = AFX_BIT(0),
+    afxIoPortFlag_ASYNC = AFX_BIT(1), // reads and writes are serviced by a kernel-level asynchronous engine.
 } afxIoPortFlags;
 
+/**
+    I/O ENGINES
+    Stream commands recorded with AfxCmdRead(), AfxCmdWrite() and friends are serviced by the engine of the bridge.
+    With afxIoEngine_URING (Linux), commands on file streams become io_uring submission entries; a whole afxSubmission
+    is queued with a single io_uring_enter(), up to sqDepth entries in flight. Streams and buffers registered with the 
+    bridge are used as fixed files and registered buffers, saving a lookup and a page pinning per operation.
+    Completions are reaped by the bridge thread and delivered into the afxSubmission flow: its signal semaphores are 
+    signaled and its fence is set once every command of it completed.
+    afxIoEngine_THREAD_POOL services the same commands with blocking calls on a pool of threadCnt threads, and is 
+    used as fallback where io_uring is not available (old kernels, or disabled by seccomp policies).
+*/
+
+typedef enum afxIoEngine
+{
+    afxIoEngine_DEFAULT, // the best one available.
+    afxIoEngine_SYNC, // commands are executed by the bridge thread, one at a time.
+    afxIoEngine_THREAD_POOL,
+    afxIoEngine_URING,
+} afxIoEngine;
+
+AFX_DEFINE_STRUCT(afxIoEngineConfig)
+{
+    afxIoEngine         engine;
+    afxBool             strict; // fail with afxError_UNSUPPORTED instead of falling back if the engine is not available.
+    afxUnit             sqDepth; // max operations in flight. Rounded up to a power of two. Default is 256.
+    afxUnit             maxFixedFiles; // slots for registered streams.
+    afxUnit             maxFixedBufs; // slots for registered buffers.
+    afxUnit             threadCnt; // threads of afxIoEngine_THREAD_POOL. If zero, Qwadro will use the threading capacity.
+};
+
 AFX_DEFINE_STRUCT(afxIoPortCaps)
 {
     afxIoPortFlags      capabilites;
@@ -35,6 +66,9 @@ AFX_DEFINE_STRUCT(afxIoPortCaps)
     afxBool8            transfer;
     afxBool8            encode;
     afxBool8            decode;
+
+    afxIoEngine         engine; // engine actually in use.
+    afxUnit             maxInFlight;
 };
 
 AFX_DEFINE_STRUCT(afxIoBridgeConfig)
@@ -43,6 +77,7 @@ AFX_DEFINE_STRUCT(afxIoBridgeConfig)
     afxIoPortFlags      capabilities;
     afxUnit             minQueCnt;
     afxReal const*      queuePriority;
+    afxIoEngineConfig   engine;
 };
 
 typedef enum
@@ -123,6 +158,16 @@ AFX afxError        _AfxWaitForIdleIoBridge(afxIoBridge exu, afxTime timeout);
 
 AFX afxError        _AfxSubmitIoCommands(afxIoBridge xexu, afxSubmission const* ctrl, afxUnit cnt, afxObject cmdbs[]);
 
+AFX afxIoEngine     AfxGetIoBridgeEngine(afxIoBridge exu);
+
+/// Registers streams as fixed files, returning their slots. Only file streams benefit; others are accepted and serviced as usual.
+AFX afxError        AfxRegisterIoFiles(afxIoBridge exu, afxUnit cnt, afxStream const files[], afxUnit slots[]);
+AFX afxError        AfxUnregisterIoFiles(afxIoBridge exu, afxUnit cnt, afxUnit const slots[]);
+
+/// Registers buffers to be read into or written from, returning their slots. Commands whose buffer lies within a registered one use it automatically.
+AFX afxError        AfxRegisterIoBuffers(afxIoBridge exu, afxUnit cnt, void* const bufs[], afxSize const sizes[], afxUnit slots[]);
+AFX afxError        AfxUnregisterIoBuffers(afxIoBridge exu, afxUnit cnt, afxUnit const slots[]);
+
 
 AFX afxUnit         AfxGetIoQueuePort(afxIoQueue xque);
 AFX afxDevLink      AfxGetIoQueueContext(afxIoQueue xque);
@@ -21,19 +21,45 @@
 
 #include "qwadro/inc/exec/afxAtomic.h"
 
+/**
+    MEMORY ORDERING
+    A ring is safe for one producer and one consumer running concurrently.
+    No counter is shared by both sides. Indices run over [0, 2 * cap), so a full ring is told apart from an empty one, and the occupancy is (writeIdx - readIdx) mod 2 * cap.
+    The producer publishes written items with a release store of writeIdx; the consumer observes them with an acquire load.
+    The consumer frees items with a release store of readIdx; the producer observes the room with an acquire load.
+    Each side keeps a cached copy of the other's index, and only reloads it when the cached copy shows no room (or no items), 
+    so the line of the other side is touched once per batch rather than once per item.
+    
+    MIRRORED MODE
+    A ring deployed with AfxDeployRing2() and afxRingFlag_MIRRORED maps its buffer twice, back to back, in virtual memory,
+    so any reservation of up to cap items is contiguous even when it wraps around the end of the buffer.
+    The capacity is rounded up so the buffer size is a multiple of the allocation granularity; mirrored rings can not grow.
+*/
+
+typedef enum afxRingFlag
+{
+    afxRingFlag_MIRRORED    = AFX_BIT(0), // double-map the buffer so reservations never split. Falls back to a plain buffer where unsupported.
+} afxRingFlags;
+
 AFX_DEFINE_STRUCT(afxRing)
 {
     afxUnit     unitSiz;
     afxUnit32   cap;
-    afxUnit32   readIdx;
-    afxUnit32   writeIdx;
-    afxAtom32   readableItemCnt;
+    afxAtom32 AFX_ALIGN(AFX_CACHE_LINE_SIZ) readIdx; // stored by the consumer only, with release.
+    afxUnit32   cachedWriteIdx; // consumer's last acquired copy of writeIdx.
+    afxAtom32 AFX_ALIGN(AFX_CACHE_LINE_SIZ) writeIdx; // stored by the producer only, with release.
+    afxUnit32   cachedReadIdx; // producer's last acquired copy of readIdx.
     afxByte*    data;
+    afxRingFlags flags; // flags actually honored.
+    afxUnit32   reservedCnt; // items reserved and not yet committed by the producer.
+    void*       mapping; // OS handle of the mirrored mapping, if any.
 };
 
 
 AFX afxError    AfxDeployRing(afxRing* ring, afxUnit unitSiz, afxUnit32 cap);
 
+AFX afxError    AfxDeployRing2(afxRing* ring, afxUnit unitSiz, afxUnit32 cap, afxRingFlags flags);
+
 AFX void        AfxDismantleRing(afxRing* ring);
 
 // ---- Producer ---- //
@@ -46,6 +72,18 @@ AFX afxUnit32   AfxGetRingNbWritableItems(afxRing* ring);
 
 AFX void        AfxIncrementRingWriteIndex(afxRing* ring, afxUnit32 itemCnt);
 
+/// Reserves up to cnt contiguous writable items, returning where to write them and setting reservedCnt to how many were reserved. 
+/// Without afxRingFlag_MIRRORED, a reservation stops at the end of the buffer. Returns NIL if the ring is full.
+AFX void*       AfxReserveRing(afxRing* ring, afxUnit32 cnt, afxUnit32* reservedCnt);
+
+/// Publishes cnt items of the last reservation to the consumer (release). cnt may be less than what was reserved.
+AFX void        AfxCommitRing(afxRing* ring, afxUnit32 cnt);
+
+// ---- Consumer ---- //
+
+/// Returns up to cnt contiguous readable items (acquire), setting readableCnt to how many. Release them with AfxIncrementRingReadIndex().
+AFX void const* AfxGetRingReadSpan(afxRing* ring, afxUnit32 cnt, afxUnit32* readableCnt);
+
 AFX afxUnit32   AfxGetRingReadIndex(afxRing* ring);
 
 AFX void const* AfxGetRingReadPtr(afxRing* ring);
@@ -58,6 +96,7 @@ AFX afxUnit32   AfxGetRingNbReadableItems(afxRing* ring);
 
 AFX afxUnit32   AfxGetRingSize(afxRing* ring);
 
+/// Not supported for mirrored rings. Not safe while the other side is running.
 AFX afxBool     AfxGrowRing(afxRing* ring, afxUnit32 growBy);
 
 #endif//AFX_RING_H
@@ -23,6 +23,9 @@
 
 #include "qwadro/inc/io/afxStream.h"
 
+// Commands are recorded, then executed asynchronously by the engine of the afxIoBridge they are submitted to; see afxIoEngine.
+// Buffers must remain valid until the submission completes.
+
 AFX afxCmdId        AfxCmdReadAt(afxStream iob, afxSize at, afxUnit rowStride, afxUnit rowCnt, afxUnit dstCap, void *dst);
 AFX afxCmdId        AfxCmdRead(afxStream iob, afxUnit rowStride, afxUnit rowCnt, afxUnit dstCap, void *dst);
 
@@ -115,7 +115,7 @@ AFX_DEFINE_STRUCT(urdSegment)
     afxUnit32       decAlign;
     afxUnit32       encSiz; // encoded/compressed size
     afxUnit32       encAlign;
-    afxUnit32       codec; // codec used to compress this section
+    afxUnit32       codec; // codec used to compress this section; a afxCodecId.
     afxUnit32       start; // where starts the data belonging to this segment.
 };
 
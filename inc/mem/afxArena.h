@@ -32,12 +32,31 @@
 #include "qwadro/inc/mem/afxMemory.h"
 #include "qwadro/inc/io/afxStream.h"
 
+#define AFX_ARENA_HWM_WINDOW 8 // cycles considered by adaptive chunk sizing.
+
 AFX_DEFINE_STRUCT(afxArenaSpecification)
 {
     afxUnit     chunkSiz;
     afxUnit     largeItemSiz;
     afxUnit     initialCleanupSiz;
     afxBool     recycle;
+    afxMemoryFlags  chunkFlags; // placement flags (afxMemoryFlag_HUGE_PAGES, etc) for chunks; when non-zero, chunks are acquired as afxMemory instead of from the MMU.
+    afxUnit     numaNode; // used with afxMemoryFlag_NODE_LOCAL only if chunkFlags also has afxMemoryFlag_NODE_GIVEN; otherwise chunks go to the node of the deploying thread.
+    afxBool     adaptive; // size new chunks from the high-water mark of previous cycles instead of chunkSiz; chunkSiz becomes the minimum.
+    afxUnit     maxChunkSiz; // upper bound for adaptive chunks. If zero, there is no bound other than largeItemSiz.
+    afxBool     keepWarm; // let AfxExhaustArena() retain the largest chunk for the next cycle instead of freeing it.
+};
+
+AFX_DEFINE_STRUCT(afxArenaStats)
+{
+    afxUnit     totalAllocated;
+    afxUnit     unusedSpace;
+    afxUnit     recycleSiz;
+    afxUnit     chunkCnt;
+    afxUnit     chunkSiz; // size that will be used for the next chunk.
+    afxUnit     highWaterMark; // greatest amount allocated in a single cycle over the rolling window.
+    afxUnit     cycleCnt; // cycles (exhaustions) seen since deployment.
+    afxReal     wasteRatio; // rolling mean of unused over reserved space at the end of each cycle.
 };
 
 AFX_DEFINE_STRUCT(afxArena)
@@ -64,11 +83,26 @@ AFX_DEFINE_STRUCT(afxArena)
     afxBool     recycleEnabled;
     void**      recycleBin;
     afxUnit     recycleSiz;
+
+    afxMemoryFlags  chunkFlags;
+    afxUnit     numaNode; // resolved at deployment; AFX_MEMORY_NODE_ANY if not bound.
+
+    // adaptive chunk sizing; a cycle ends at each AfxExhaustArena().
+    afxBool     adaptive;
+    afxUnit     minChunkSiz;
+    afxUnit     maxChunkSiz;
+    afxUnit     cycleHwm[AFX_ARENA_HWM_WINDOW]; // total allocated at the end of the last cycles.
+    afxUnit     cycleCnt;
+    afxReal     wasteRatio;
+    afxBool     keepWarm;
+    void*       warmChunk; // largest chunk retained by the last exhaustion.
+    afxUnit     warmChunkSiz;
 };
 
 AFX afxError    AfxDeployArena(afxArena* aren, afxArenaSpecification const *spec, afxHere const hint);
 AFX void        AfxDismantleArena(afxArena* aren);
 
+/// Frees every unit, ending a cycle. Adaptive arenas record the cycle high-water mark; arenas with keepWarm retain their largest chunk.
 AFX void        AfxExhaustArena(afxArena* aren);
 
 AFX void        AfxRecycleArenaUnit(afxArena* aren, void* p, afxSize size);
@@ -91,6 +125,27 @@ AFX void        AfxDumpArenaStats(afxArena* aren, afxStream out);
 
 AFX void        AfxGetArenaInfo(afxArena* aren, afxUnit* totalAllocated, afxUnit* unusedSpace, afxUnit* recycleSiz);
 
+AFX void        AfxDescribeArena(afxArena const* aren, afxArenaStats* stats);
+
 AFX void        AfxLogArenaStats(afxArena* aren);
 
+/// FRAME ARENAS
+/// Each thread owns a pair of arenas for each short allocation duration (afxMemFlag_TEMPORARY and afxMemFlag_TRANSIENT), used alternately.
+/// Advancing a duration flips its pair and exhausts the arena becoming current, so a unit survives exactly one boundary after the one it was requested in.
+/// TRANSIENT arenas are advanced by the system at each iteration of the thread event loop.
+/// TEMPORARY arenas are advanced at job boundaries, but only when the job nesting depth of the thread returns to zero: jobs also run inline 
+/// on the thread waiting for them (AfxWaitForJobCounter(), AfxDoService(), AfxParallelFor(), etc), and an inner job finishing must not reset 
+/// units the outer one still holds. Threads which are not service workers also advance TEMPORARY at each iteration of their loop, at depth zero.
+/// A thread running a afxFiber uses the TEMPORARY pair of the fiber instead of its own (see afxThread.h), so jobs parked on a wait keep their units.
+/// Units requested from frame arenas are never deallocated individually.
+
+/// Returns the current frame arena of the calling thread for the duration in flags, or NIL if flags does not specify TEMPORARY or TRANSIENT.
+AFX afxArena*   AfxGetFrameArena(afxMemFlags flags);
+
+AFX void*       AfxRequestFrameUnit(afxMemFlags flags, afxSize siz, afxUnit align);
+
+/// Flips and resets the frame arenas of the calling thread for every duration specified in flags. 
+/// TEMPORARY is skipped while the calling thread (or fiber) is running a job, since an outer job may still hold units in it.
+AFX void        AfxAdvanceFrameArenas(afxMemFlags flags);
+
 #endif//AFX_ARENA_H
@@ -46,6 +46,21 @@
     std::vector(for T other than bool) meets the requirements of Container, MemoryAwareContainer, SequenceContainer, ContiguousContainer(since C++17) and ReversibleContainer.
 */
 
+/**
+    GROWTH POLICY
+    When a push exceeds the capacity, the new capacity is the greatest of what is required, 
+    1.5x the current capacity and AFX_ARRAY_MIN_CAP units; so pushes are amortized O(1).
+    Capacity never shrinks implicitly; call AfxShrinkArray() to return the excess.
+
+    SMALL-BUFFER MODE
+    A buffer passed to AfxMakeArray() is kept as inline storage. It is never freed by the array;
+    the content moves to the heap when it outgrows it, and back into it when AfxShrinkArray() finds it fits again.
+    AfxMakeInlineArray() declares both the array and such a buffer on the stack, as in AfxMakeInlineArray(pvs, int, 16);
+*/
+
+#define AFX_ARRAY_MIN_CAP 8
+#define AfxGetArrayGrowth(cap_, req_) AfxMax((req_), AfxMax((cap_) + ((cap_) >> 1), AFX_ARRAY_MIN_CAP))
+
 AFX_DEFINE_STRUCT(afxArray)
 {
     afxUnit      unitSiz;
@@ -57,10 +72,18 @@ AFX_DEFINE_STRUCT(afxArray)
         void*   data;
     };
     afxBool     alloced;
+    void*       inlineBuf; // caller-provided storage; NIL if none.
+    afxUnit     inlineCap;
 };
 
 #define AfxArray(type_, cap_, initialVal_) AfxMakeArray((cap_), sizeof(type_), (initialVal_) ? ((type_ const[]){(initialVal_)}) : NIL)
 
+// Declares afxArray arr_ and its inline buffer arr_##InlineBuf, then makes the array over the buffer. arr_ must be a plain identifier.
+#define AfxMakeInlineArray(arr_, type_, inlineCap_) \
+    afxArray arr_; \
+    type_ AFX_SIMD arr_##InlineBuf[(inlineCap_)]; \
+    AfxMakeArray(&(arr_), sizeof(type_), (inlineCap_), arr_##InlineBuf, 0)
+
 AFXINL afxError     AfxMakeArray(afxArray* arr, afxUnit unitSiz, afxUnit cap, void* buf, afxUnit pop);
 AFXINL void         AfxCleanUpArray(afxArray* arr);
 
@@ -76,6 +99,16 @@ AFXINL afxError     AfxUpdateArrayUnits(afxArray *arr, afxUnit base, afxUnit cnt
 
 AFXINL afxError     AfxReserveArraySpace(afxArray *arr, afxUnit cap);
 
+/// Reallocates the storage to fit the population exactly, moving it back to the inline storage if it fits there. An empty array releases its heap storage.
+AFXINL afxError     AfxShrinkArray(afxArray *arr);
+
+/// Moves the storage out of the array, leaving it empty (and back on its inline storage, if any). The caller becomes responsible for calling AfxDeallocate() on data.
+/// Zero-copy when the storage is on the heap; content held in inline storage is copied into a new heap block.
+AFXINL afxError     AfxStealArray(afxArray *arr, afxUnit* cap, afxUnit* pop, void** data);
+
+/// Releases the current storage and takes ownership of data, which must have been allocated with AfxAllocate() and hold room for cap units of which pop are populated.
+AFXINL afxError     AfxAdoptArray(afxArray *arr, afxUnit cap, afxUnit pop, void* data);
+
 #define             AfxForEachArrayUnit(arr_, iterIdx_, unitPtr_) for (afxUnit iterIdx_ = 0; (arr_)->cnt > iterIdx_, (unitPtr_ = AfxGetArrayUnit(arr_, iterIdx_)); iterIdx_++)
 #define             AfxForEachArrayItem(arr_, iterIdx_, unitPtr_) for (afxUnit iterIdx_ = 0; (arr_)->cnt > iterIdx_, (unitPtr_ = AfxGetArrayUnit(arr_, iterIdx_)); iterIdx_++)
 
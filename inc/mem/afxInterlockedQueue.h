@@ -25,6 +25,7 @@
 #include "qwadro/inc/base/afxCoreDefs.h"
 #include "qwadro/inc/base/afxDebug.h"
 #include "qwadro/inc/exec/afxAtomic.h"
+#include "qwadro/inc/exec/afxTime.h"
 
 AFX_DEFINE_STRUCT(afxInterlockedQueue)
 {
@@ -39,8 +40,13 @@ AFX_DEFINE_STRUCT(afxInterlockedQueue)
 #endif
     afxUnit         unitSiz;
     afxInt32        queIdxMask; /// Mask to apply to the read/write position to clamp it to array bounds
-    afxAtom32       readPosn; /// readIdx of where we are in the sequence
-    afxAtom32       writePosn; /// writeIdx of where we are in the sequence
+    afxBool         blocking; /// Waiters are supported; set by AfxDeployInterlockedQueue2().
+    /// Positions are kept on their own cache lines so that producers and consumers do not false-share.
+    afxAtom32 AFX_ALIGN(AFX_CACHE_LINE_SIZ) readPosn; /// readIdx of where we are in the sequence
+    afxAtom32 AFX_ALIGN(AFX_CACHE_LINE_SIZ) writePosn; /// writeIdx of where we are in the sequence
+    afxAtom32 AFX_ALIGN(AFX_CACHE_LINE_SIZ) pushSeq; /// Bumped on each push while consumers wait; futex/wait-on-address word.
+    afxAtom32       popSeq; /// Bumped on each pop while producers wait; futex/wait-on-address word.
+    afxAtom32       waiterCnt;
 };
 
 /// Inicializa a fila afxInterlockedQueue e aloca memria para o nmero especificado de entradas.
@@ -64,4 +70,23 @@ AFX afxBool     AfxPushInterlockedQueue(afxInterlockedQueue* ique, void* src);
 /// Retorna TRUE se um valor foi sucessivamente desenfileirado, FALSE caso contrrio (se FALSE, data no ser escrito.
 AFX afxBool     AfxPopInterlockedQueue(afxInterlockedQueue* ique, void* value);
 
+/// Same as AfxDeployInterlockedQueue() but also enabling the blocking waits. Non-blocking queues never touch the wait words.
+AFX afxError    AfxDeployInterlockedQueue2(afxInterlockedQueue* ique, afxUnit unitSiz, afxUnit cap, afxBool blocking);
+
+/// Enqueues up to cnt values from src, claiming the slots with a single CAS on writePosn.
+/// Returns the number of values enqueued, which is less than cnt only if the queue filled up.
+AFX afxUnit     AfxPushInterlockedQueueBatch(afxInterlockedQueue* ique, afxUnit cnt, void const* src, afxUnit srcStride);
+
+/// Dequeues up to cnt values into dst, claiming the slots with a single CAS on readPosn. Returns the number of values dequeued.
+AFX afxUnit     AfxPopInterlockedQueueBatch(afxInterlockedQueue* ique, afxUnit cnt, void* dst, afxUnit dstStride);
+
+/// Blocking variants; the queue must have been deployed with blocking enabled.
+/// timeout is in microseconds; AFX_TIME_INFINITE waits indefinitely. They spin briefly, then park on a futex (wait-on-address on Windows).
+/// Return afxError_TIMEOUT if nothing could be done in time.
+AFX afxError    AfxPushInterlockedQueueWait(afxInterlockedQueue* ique, void const* src, afxTime timeout);
+AFX afxError    AfxPopInterlockedQueueWait(afxInterlockedQueue* ique, void* value, afxTime timeout);
+
+/// Wakes every thread parked on the queue, e.g. before dismantling it. Woken waiters return afxError_TIMEOUT if they still can not proceed.
+AFX void        AfxWakeInterlockedQueue(afxInterlockedQueue* ique);
+
 #endif//AFX_INTERLOCKED_QUEUE_H
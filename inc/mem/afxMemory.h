@@ -31,6 +31,7 @@
 #include "qwadro/inc/base/afxChain.h"
 #include "qwadro/inc/base/afxFcc.h"
 #include "qwadro/inc/exec/afxSlock.h"
+#include "qwadro/inc/exec/afxClock.h"
 #include "qwadro/inc/io/afxUri.h"
 
 typedef enum afxAllocationFlags
@@ -100,7 +101,153 @@ AFX_DEFINE_STRUCT(afxAllocator)
 
 typedef void*(*ator)(afxMmu mmu, void* old, afxSize siz, afxSize align, afxHere const hint); // if siz is zero, memory is freed
 
+/// MAGAZINE CACHING
+/// When caching is enabled, each thread keeps magazines (small LIFO stacks of free blocks), one pair per size class, in front of the MMU callbacks.
+/// Allocations and deallocations satisfied by a magazine never take memSlock; a miss exchanges a whole magazine with the MMU depot.
+/// Blocks deallocated by a thread other than the one which allocated them are pushed into the owner's lock-free remote list and reclaimed on its next miss.
+/// Allocations above maxUnitSiz, or with an alignment stricter than its size class, go straight through allocCb/deallocCb.
+/// Cached blocks are carved from spans of AFX_MMU_SPAN_SIZ bytes, aligned to their size and registered in the MMU span map.
+/// Span descriptors are kept out of line, in the span map, so the whole span holds blocks and no size class wastes room on a header.
+/// On deallocation the span base is found by masking the address; its descriptor gives the size class and the owner thread cache. Addresses with no span were bypassed.
+/// Thread caches are bound to a thread-specific key with a destructor (pthread_key_create, FlsAlloc on Windows), so magazines of any thread, including foreign ones never wrapped by a afxThread, are flushed when it exits.
+
+#define AFX_MMU_MAG_MIN_UNIT_SIZ    16
+#define AFX_MMU_MAG_MAX_UNIT_SIZ    32768
+#define AFX_MMU_MAG_CLASS_CNT       12 // power-of-two size classes from AFX_MMU_MAG_MIN_UNIT_SIZ to AFX_MMU_MAG_MAX_UNIT_SIZ.
+#define AFX_MMU_MAG_DEF_CAP         64
+#define AFX_MMU_SPAN_SHIFT          16
+#define AFX_MMU_SPAN_SIZ            (1u << AFX_MMU_SPAN_SHIFT) // 64 KiB; must be greater than AFX_MMU_MAG_MAX_UNIT_SIZ.
+
+AFX_DEFINE_STRUCT(afxMmuCacheConfig)
+{
+    afxUnit     maxUnitSiz; // allocations larger than this bypass the magazines. If zero, Qwadro will use AFX_MMU_MAG_MAX_UNIT_SIZ.
+    afxUnit     magCap; // blocks per magazine. If zero, Qwadro will use AFX_MMU_MAG_DEF_CAP.
+    afxUnit     depotCap; // max full magazines retained by the MMU depot per size class; surplus is returned through deallocCb.
+    afxUnit     trimPeriod; // (de)allocations done by a thread between trims of its magazines to the depot. If zero, thread caches are only trimmed explicitly.
+};
+
+// Counters are kept per thread cache, written only by their thread, and summed by AfxGetMmuCacheStats().
+AFX_DEFINE_STRUCT(afxMmuCacheStats)
+{
+    afxUnit64   hitCnt; // (de)allocations satisfied by a thread magazine.
+    afxUnit64   missCnt; // magazine exchanges with the depot.
+    afxUnit64   bypassCnt; // (de)allocations which went straight to the MMU callbacks.
+    afxUnit64   remoteFreeCnt; // blocks deallocated by a thread other than its owner; counted by the deallocating thread.
+    afxUnit64   trimCnt;
+    afxSize     cachedSiz; // bytes currently held in magazines and in the depot.
+    afxUnit     threadCacheCnt;
+};
+
+/// ALLOCATION ACCOUNTING
+/// When accounting is enabled, every live allocation is registered against its afxHere site and against the afxClass owning the calling scope.
+/// Objects are constructed and destructed under the scope of their class, so memory allocated by ctors and dtors is attributed to it.
+/// Churn is measured over a rolling window of one second.
+/// Each accounted allocation is recorded in a side table mapping its address to its site and size, so a deallocation is charged to the site which allocated it, not to the hint of the call freeing it.
+/// The side table is split into AFX_MMU_TAG_STRIPE_CNT stripes selected by address, each with its own slock. Site counters are not updated in place;
+/// every thread accumulates deltas in its thread cache, which are folded into the sites on trims, on thread exit and before any query or snapshot.
+
+AFX_DEFINE_STRUCT(afxMemorySiteInfo)
+{
+    afxChar const*  file;
+    afxUnit         line;
+    afxChar const*  func;
+    afxClass*       cls; // owning class; NIL if allocated outside of any class scope.
+    afxSize         liveSiz;
+    afxUnit         liveCnt;
+    afxSize         peakSiz;
+    afxUnit64       allocCnt; // total since accounting was enabled.
+    afxUnit64       deallocCnt; // total since accounting was enabled.
+    afxReal         churnRate; // (de)allocations per second.
+};
+
+AFX_DEFINE_STRUCT(afxMemorySiteDiff)
+{
+    afxChar const*  file;
+    afxUnit         line;
+    afxChar const*  func;
+    afxClass*       cls;
+    afxInt64        liveSizDelta;
+    afxInt          liveCntDelta;
+    afxUnit64       allocCnt; // allocations done between the snapshots.
+    afxUnit64       deallocCnt; // deallocations done between the snapshots.
+};
+
+AFX_DEFINE_STRUCT(afxMemorySnapshot)
+{
+    afxMmu              mmu;
+    afxClock            time;
+    afxUnit             siteCnt;
+    afxMemorySiteInfo*  sites; // sorted by site.
+    afxSize             liveSiz;
+};
+
 #ifdef _AFX_MMU_C
+#define AFX_MMU_TAG_STRIPE_CNT      64
+#define AFX_MMU_SITE_DELTA_CNT      32 // deltas held by a thread cache before it must fold them.
+
+AFX_DEFINE_STRUCT(afxMemorySite)
+{
+    afxLink                     mmu; // afxMmu::sites
+    afxMemorySite*              nextInBucket; // buckets are published with release stores and searched without locking; sites are only removed when accounting is disabled.
+    afxMemorySiteInfo           info; // updated while folding deltas, under sitesSlock.
+    afxAtom32                   windowOps;
+};
+
+// Side table record of one live accounted allocation.
+AFX_DEFINE_STRUCT(afxMemoryTag)
+{
+    void*                       p;
+    afxMemorySite*              site;
+    afxSize                     siz;
+};
+
+AFX_DEFINE_STRUCT(afxMemoryTagStripe)
+{
+    afxSlock                    slock;
+    afxUnit                     tagCnt;
+    afxUnit                     tagCap; // power of two; open addressing by address.
+    afxMemoryTag*               tags;
+};
+
+AFX_DEFINE_STRUCT(afxMemorySiteDelta)
+{
+    afxMemorySite*              site;
+    afxInt64                    liveSiz;
+    afxInt                      liveCnt;
+    afxUnit                     allocCnt;
+    afxUnit                     deallocCnt;
+};
+
+AFX_DEFINE_STRUCT(afxMmuMagazine)
+{
+    afxMmuMagazine*             next; // used when chained in the depot.
+    afxUnit                     cnt;
+    void*                       units[]; // magCap entries.
+};
+
+AFX_DEFINE_STRUCT(afxMmuThreadCache)
+{
+    afxLink                     mmu; // afxMmu::caches
+    afxUnit32                   tid;
+    afxUnit                     opCnt; // (de)allocations since last trim.
+    afxMmuMagazine*             loaded[AFX_MMU_MAG_CLASS_CNT];
+    afxMmuMagazine*             prev[AFX_MMU_MAG_CLASS_CNT];
+    afxAtomPtr                  remoteFrees; // singly-linked through the freed blocks themselves.
+    afxMmuCacheStats            stats; // written by this thread only; cachedSiz and threadCacheCnt are left zero.
+    afxSlock                    deltaSlock; // only contended while another thread folds the deltas for a query.
+    afxUnit                     deltaCnt;
+    afxMemorySiteDelta          deltas[AFX_MMU_SITE_DELTA_CNT]; // accounting deltas not yet folded into their sites.
+};
+
+// Descriptor of a span, allocated out of line; the span map resolves (addr & ~(AFX_MMU_SPAN_SIZ - 1)) to it. The span itself holds blocks only.
+AFX_DEFINE_STRUCT(afxMmuSpan)
+{
+    afxMmuSpan*                 nextInBucket;
+    afxByte*                    base; // span start; aligned to AFX_MMU_SPAN_SIZ.
+    afxUnit                     sizClass;
+    afxAtomPtr                  owner; // afxMmuThreadCache whose remoteFrees receives blocks freed by other threads; NIL once adopted by the depot.
+};
+
 AFX_OBJECT(afxMmu)
 {
     afxAllocCallback            allocCb;
@@ -119,6 +266,29 @@ AFX_OBJECT(afxMmu)
     afxChain                    memChain;
     afxSize                     defAlign;
 
+// magazine caching
+    afxBool                     cachingEnabled;
+    afxSize                     cacheKey; // pthread_key_t (FLS index on Windows) holding the afxMmuThreadCache of each thread; its destructor flushes it.
+    afxMmuCacheConfig           cacheCfg;
+    afxSlock                    depotSlock; // guards caches and depots; never taken on the magazine fast path.
+    afxChain                    caches; // afxMmuThreadCache
+    afxMmuMagazine*             fullDepot[AFX_MMU_MAG_CLASS_CNT];
+    afxMmuMagazine*             emptyDepot[AFX_MMU_MAG_CLASS_CNT];
+    afxUnit                     fullDepotCnt[AFX_MMU_MAG_CLASS_CNT];
+    afxMmuCacheStats            retiredStats; // counters folded in from thread caches already flushed; guarded by depotSlock.
+    afxSize                     cachedSiz; // guarded by depotSlock.
+    afxUnit                     spanBucketCnt; // power of two
+    afxMmuSpan* volatile*       spanBuckets; // hashed by span base; published with release stores and read lock-free. Spans are only unlinked while caching is being disabled.
+
+// accounting
+    afxBool                     accountingEnabled;
+    afxSlock                    sitesSlock; // taken only to insert a site seen for the first time and to fold deltas.
+    afxChain                    sites; // afxMemorySite
+    afxUnit                     siteBucketCnt; // power of two
+    afxMemorySite* volatile*    siteBuckets; // hashed by (file, line, cls).
+    afxMemoryTagStripe          tagStripes[AFX_MMU_TAG_STRIPE_CNT]; // live allocation address -> site.
+    afxClock                    windowStart;
+
 // debug
     afxUnit                      dbgLevel; // 0 - nothing, 1 - mechanism activity, 2 - block activity, 3 - portion (de)allocations, 4 - [implementation-dependent]
     afxChar const*              func;
@@ -133,23 +303,89 @@ typedef enum afxMemoryFlag
     afxMemoryFlag_W = AFX_BIT(1),
     afxMemoryFlag_X = AFX_BIT(2),
 
-
+    // placement
+    afxMemoryFlag_HUGE_PAGES    = AFX_BIT(8), // advise the OS to back the memory with transparent huge pages. Ignored where unsupported.
+    afxMemoryFlag_LARGE_PAGES   = AFX_BIT(9), // back the memory with explicit (reserved) large pages. Falls back to afxMemoryFlag_HUGE_PAGES, then to plain pages, if they can not be obtained.
+    afxMemoryFlag_NODE_LOCAL    = AFX_BIT(10), // bind the memory to a NUMA node; the one of the calling thread unless afxMemoryFlag_NODE_GIVEN is also specified. Falls back to the OS default policy on non-NUMA hosts.
+    afxMemoryFlag_STRICT        = AFX_BIT(11), // fail with afxError_UNSUPPORTED instead of falling back when a placement can not be honored.
+    afxMemoryFlag_NODE_GIVEN    = AFX_BIT(12), // the accompanying numaNode is valid; without it, zero-initialized node fields are ignored.
 } afxMemoryFlags;
 
+#define AFX_MEMORY_NODE_ANY AFX_INVALID_INDEX
+
+AFX_DEFINE_STRUCT(afxMemoryPlacement)
+{
+    afxMemoryFlags  flags; // placement flags actually honored.
+    afxUnit         pageSiz; // size of the pages backing the memory.
+    afxUnit         numaNode; // AFX_MEMORY_NODE_ANY if not bound.
+};
+
 AFX afxError                AfxOpenMemory(afxMemoryFlags flags, afxUri const* uri, afxHere const hint, afxMemory* memory);
 AFX afxError                AfxAcquireMemory(afxMemoryFlags flags, afxSize siz, afxUri const* uri, afxHere const hint, afxMemory* memory);
 
+/// Same as AfxAcquireMemory() but binding the memory to numaNode when afxMemoryFlag_NODE_LOCAL is specified. afxMemoryFlag_NODE_GIVEN is implied; pass AFX_MEMORY_NODE_ANY for the node of the calling thread.
+AFX afxError                AfxAcquireMemoryOnNode(afxMemoryFlags flags, afxSize siz, afxUnit numaNode, afxUri const* uri, afxHere const hint, afxMemory* memory);
+
+AFX void                    AfxDescribeMemoryPlacement(afxMemory mem, afxMemoryPlacement* placement);
+
+/// Returns the size of explicit large pages supported by the host, or zero if not supported.
+AFX afxSize                 AfxGetLargePageSize(void);
+
+/// Returns the NUMA node of the processor running the calling thread; zero on non-NUMA hosts.
+AFX afxUnit                 AfxGetCurrentNumaNode(void);
+
 AFX afxError                AfxMapMemory(afxMemory mem, afxSize offset, afxUnit range, afxFlags flags, void** var);
 AFX afxError                AfxUnmapMemory(afxMemory mem, afxSize offset, afxUnit range);
 
 AFX afxError                AfxMemoryEnableDebugging(afxMmu mmu, afxUnit level);
 AFX afxSize                 AfxMemoryGetDefaultAlignment(afxMmu mmu);
 
+/// Enables per-thread magazine caching in front of the MMU callbacks. Pass NIL as cfg to disable it, draining every magazine back to the MMU.
+AFX afxError                AfxEnableMmuCaching(afxMmu mmu, afxMmuCacheConfig const* cfg);
+
+/// Returns magazines of every thread cache in excess of one per size class to the depot, and depot surplus to the MMU. If releaseAll is TRUE, everything is released.
+AFX void                    AfxTrimMmuCaches(afxMmu mmu, afxBool releaseAll);
+
+/// Returns all magazines of the calling thread to the depot, hands its spans over to the depot and folds its counters into the MMU. 
+/// Called by the TLS destructor of the thread cache when any thread exits; calling it earlier is only needed to release memory sooner.
+AFX void                    AfxFlushMmuThreadCache(afxMmu mmu);
+
+/// Sums the counters of every live thread cache with those of retired ones. Counters of running threads may lag by their in-flight operations.
+AFX void                    AfxGetMmuCacheStats(afxMmu mmu, afxMmuCacheStats* stats);
+
+/// Enables or disables the live-allocation registry. Allocations made while it was disabled are not accounted when deallocated.
+AFX afxError                AfxEnableMemoryAccounting(afxMmu mmu, afxBool enable);
+
+/// Attributes allocations done by the calling thread to cls until the matching pop. Scopes nest. On a afxFiber, scopes belong to the fiber and follow it across threads.
+AFX void                    AfxPushMemoryOwner(afxClass* cls);
+AFX void                    AfxPopMemoryOwner(void);
+
+/// Pass NIL into sites to return the total number of sites.
+AFX afxUnit                 AfxQueryMemorySites(afxMmu mmu, afxUnit first, afxUnit cnt, afxMemorySiteInfo sites[]);
+
+/// Sums every site attributed to cls. Returns FALSE if nothing was ever attributed to it.
+AFX afxBool                 AfxQueryClassMemory(afxMmu mmu, afxClass const* cls, afxMemorySiteInfo* info);
+
+AFX afxError                AfxTakeMemorySnapshot(afxMmu mmu, afxMemorySnapshot* snap);
+AFX void                    AfxReleaseMemorySnapshot(afxMemorySnapshot* snap);
+
+/// Computes the per-site growth from one snapshot to another, largest growth first; sites unchanged between them are skipped. Pass NIL into diffs to return the count of changed sites.
+AFX afxUnit                 AfxDiffMemorySnapshots(afxMemorySnapshot const* from, afxMemorySnapshot const* to, afxUnit cnt, afxMemorySiteDiff diffs[]);
+
+/// Writes a report of live sites, largest first, followed by per-class totals.
+AFX afxError                AfxDumpMemorySites(afxMmu mmu, afxStream out);
+
 AFX afxError                AfxAllocate(afxSize siz, afxUnit align, afxHere const hint, void** pp);
 AFX afxError                AfxCoallocate(afxSize siz, afxSize cnt, afxUnit align, afxHere const hint, void** pp);
 AFX afxError                AfxReallocate(afxSize siz, afxUnit align, afxHere const hint, void** pp);
 AFX afxError                AfxDeallocate(void** pp, afxHere const hint);
 
+/// Allocates routing by duration: afxMemFlag_TEMPORARY and afxMemFlag_TRANSIENT are served by the frame arenas of the calling thread (see AfxRequestFrameUnit()), 
+/// while afxMemFlag_PERMANENT, or no duration at all, goes to the general heap as AfxAllocate() does. Memory served by a frame arena must not be passed to AfxDeallocate().
+/// TEMPORARY units live until the outermost job running on the thread ends, jobs run inline while waiting included, or, on threads which are not service workers, 
+/// until the next iteration of the thread loop. TRANSIENT units live until the next iteration of the thread loop. See FRAME ARENAS in afxArena.h.
+AFX afxError                AfxAllocate2(afxSize siz, afxUnit align, afxMemFlags flags, afxHere const hint, void** pp);
+
 #define                     AfxStream(cnt_,srcStride_,dstStride_,src_,dst_) AfxStream2(cnt_,src_,srcStride_,dst_,dstStride_)
 AFX void                    AfxStream2(afxUnit cnt, void const* src, afxSize srcStride, void* dst, afxUnit dstStride);
 AFX void                    AfxStream3(afxUnit cnt, void const* src, afxUnit srcOffset, afxSize srcStride, void* dst, afxUnit dstOffset, afxUnit dstStride);
@@ -23,10 +23,17 @@
 
 #define AFX_POOL_ALIGNMENT AFX_SIMD_ALIGNMENT
 
+#define AFX_POOL_BITMAP_WORD_BITS 64
+
+/// Occupancy of each page is tracked in a bitmap of ceil(unitsPerPage / 64) words, one bit per unit, set when the unit is in use.
+/// Pages with at least one free unit are chained in a free-page list, so AfxPushPoolUnit() takes the head page and finds its slot with a single bit scan per word.
+/// Enumeration and invocation skip empty pages and visit only set bits, costing in proportion to live units rather than to capacity.
+
 AFX_DEFINE_STRUCT(afxPoolPage)
 {
     afxUnit         usedCnt;
-    afxUnit32       usage;
+    afxUnit         nextFreePage; // next page in the free-page list; AFX_INVALID_INDEX if this is the last one or the page is full.
+    afxUnit64*      usage; // occupancy bitmap.
     afxByte*        data;
 };
 
@@ -35,18 +42,26 @@ AFX_DEFINE_STRUCT(afxPool)
     afxUnit         unitSiz;
     afxUnit         memAlign;
     afxUnit         unitsPerPage;
+    afxUnit         bitmapWordCnt; // words in the occupancy bitmap of each page.
     afxUnit         totalUsedCnt;
     afxUnit         pageCnt;
+    afxUnit         firstFreePage; // head of the free-page list; AFX_INVALID_INDEX if every page is full.
     afxPoolPage*    pages;
     afxMmu          mem;
 };
 
+/// unitsPerPage may be any non-zero value; it is no more bounded to the 32 bits of a single occupancy word.
 AFX void        AfxDeployPool(afxPool* pool, afxUnit unitSiz, afxUnit unitsPerPage, afxUnit memAlign);
 AFX void        AfxDismantlePool(afxPool* pool);
 
 AFX void*       AfxPushPoolUnit(afxPool* pool, afxSize* idx);
 AFX afxError    AfxPushPoolUnits(afxPool* pool, afxUnit cnt, void* units[]);
 
+/// Reserves up to cnt units laid out contiguously, with a stride of unitSiz, within a single page: the longest run of free slots in the head free page, or a fresh page.
+/// Since every page holds exactly unitsPerPage units, a run never crosses a page; larger batches are reserved as one run per page by calling it repeatedly.
+/// The indices of the run are consecutive from firstIdx. units may be NIL if only the indices are wanted. Returns the number of units reserved; zero on failure.
+AFX afxUnit     AfxPushPoolRun(afxPool* pool, afxUnit cnt, afxUnit* firstIdx, void* units[]);
+
 AFX void        AfxPopPoolUnit(afxPool* pool, void* unit);
 AFX void        AfxPopPoolUnits(afxPool* pool, afxUnit cnt, void* units[]);
 
@@ -64,4 +79,8 @@ AFX afxUnit     AfxEnumeratePoolUnits(afxPool const* pool, afxUnit first, afxUni
 AFX afxUnit     AfxInvokePoolItems(afxPool const* pool, afxUnit first, afxUnit cnt, afxBool(*f)(void* item, void* udd), void *udd);
 AFX afxUnit     AfxInvokePoolUnits(afxPool const* pool, afxUnit first, afxUnit cnt, afxBool freeOnly, afxBool (*f)(void* item, void* udd), void *udd);
 
+/// Parallel counterpart of AfxInvokePoolItems(), run on the system service with AfxParallelFor(); pages are split in grain-sized chunks of live units.
+/// The pool must not be modified while it runs. A callback returning FALSE prevents chunks not yet started from running. Returns the count of invocations.
+AFX afxUnit     AfxInvokePoolItemsParallel(afxPool const* pool, afxUnit first, afxUnit cnt, afxUnit grain, afxParallelFlags flags, afxBool(*f)(void* item, void* udd), void *udd);
+
 #endif//AFX_POOL_H
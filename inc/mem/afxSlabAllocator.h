@@ -65,4 +65,74 @@ AFX afxError    AfxPopSlabUnit(afxSlabAllocator* mgr, void* p);
 
 AFX void*       AfxPushSlabUnit(afxSlabAllocator* mgr);
 
+/**
+    afxConcurrentSlabAllocator is the thread-safe variant, intended for small objects with heavy churn (afxCapstan, afxEvent, etc).
+    No lock is taken on any path; callers must not wrap it in their own.
+
+    Slabs are allocated aligned to slabSiz (a power of two, at least 4096), so the slab owning a unit is found by masking its address.
+    Hot slabs are kept in AFX_SLAB_HOT_CNT slots, which threads select by tid. A thread owns a slot only after claiming it by CAS'ing its tid into hotTid of the slot slab;
+    while the slot is held by another thread, it allocates straight from the partial list instead. A claim lasts until the hot slab runs dry, 
+    or until AfxReleaseConcurrentSlabClaims() drops it; the system calls it on thread teardown, as it calls AfxFlushMmuThreadCache().
+    Each slab has two free lists. The local list is touched only by the thread holding the slab (its hot slot owner, or a thread which took it off the partial list), 
+    so pushing from it takes no atomic operation. Units popped by any other thread are CAS'd into the remote list, which is push-only and thus free of ABA;
+    the holder takes the remote list whole, by atomic exchange, when its local list runs dry.
+    The partial and empty lists are updated with a double-width CAS (cmpxchg8b/cmpxchg16b on x86, CASP on ARM64) of a pointer paired with a pointer-wide tag 
+    bumped on every exchange, so the tag can not wrap within any realistic window of a stalled thread on any target.
+    Slabs which become entirely free are retained up to maxEmptySlabs; further ones stay in the empty list until AfxReclaimConcurrentSlabs() returns them to the MMU.
+*/
+
+#define AFX_SLAB_HOT_CNT 64 // slots for hot slabs; a thread maps to slot (tid % AFX_SLAB_HOT_CNT) and must claim it before use.
+
+AFX_DECLARE_STRUCT(afxConcurrentSlab);
+
+AFX_DEFINE_STRUCT_ALIGNED(16, afxConcurrentSlabList)
+// Head of a lock-free slab list; exchanged whole by a double-width CAS, hence aligned to twice the pointer size (16 on 64-bit targets).
+{
+    afxConcurrentSlab*  first;
+    afxSize             tag; // bumped on every exchange.
+};
+
+AFX_DEFINE_STRUCT(afxConcurrentSlab)
+{
+    afxConcurrentSlab*  next; // in the partial or empty list.
+    afxUnit32           localHead; // index of the first unit of the local free list; AFX_INVALID_INDEX32 if empty. Holder only.
+    afxAtom32           remoteHead; // index of the first unit of the remote free list; AFX_INVALID_INDEX32 if empty.
+    afxAtom32           freeCnt;
+    afxAtom32           hotTid; // tid of the thread which claimed it as hot slab; zero if none. Claimed and released by CAS.
+    afxUnit             unitCnt;
+    afxByte AFX_ADDR    units[];
+};
+
+AFX_DEFINE_STRUCT(afxConcurrentSlabAllocator)
+{
+    afxUnit             unitSiz;
+    afxUnit             unitsPerSlab;
+    afxUnit             slabSiz;
+    afxUnit             maxEmptySlabs;
+    afxMmu              mmu;
+    afxConcurrentSlabList partial;
+    afxConcurrentSlabList empty;
+    afxAtom32           emptyCnt;
+    afxAtom32           slabCnt;
+    afxAtomPtr          hot[AFX_SLAB_HOT_CNT];
+    afxLink             sys; // chained in the system list walked by AfxReleaseConcurrentSlabClaims().
+};
+
+AFX afxError    AfxDeployConcurrentSlabAllocator(afxConcurrentSlabAllocator* mgr, afxUnit unitSiz, afxUnit unitsPerSlab, afxUnit maxEmptySlabs);
+
+/// All units must have been popped. Must not be called concurrently with any other operation on mgr.
+AFX afxError    AfxDismantleConcurrentSlabAllocator(afxConcurrentSlabAllocator* mgr);
+
+AFX afxError    AfxPopConcurrentSlabUnit(afxConcurrentSlabAllocator* mgr, void* p);
+
+AFX void*       AfxPushConcurrentSlabUnit(afxConcurrentSlabAllocator* mgr);
+
+/// Returns empty slabs in excess of maxEmptySlabs to the MMU. Returns the number of slabs released.
+/// Lock-free pops may still be reading the link of a slab being released, so, like dismantling, it must not be called concurrently with any other operation on mgr.
+AFX afxUnit     AfxReclaimConcurrentSlabs(afxConcurrentSlabAllocator* mgr);
+
+/// Releases every hot slot claimed by the thread tid, in every deployed concurrent slab allocator, returning the slabs to the partial list. 
+/// Called by the system when a thread is torn down; a thread may call it for itself before blocking for long.
+AFX void        AfxReleaseConcurrentSlabClaims(afxUnit32 tid);
+
 #endif//AFX_SLAB_ALLOCATOR_H
\ No newline at end of file
@@ -93,6 +93,7 @@ ASX afxDrawInput    AfxGetSimulationDrawInput(afxSimulation sim);
 
 ASX afxUnit         AfxEnumerateBodies(afxSimulation sim, afxUnit first, afxUnit cnt, afxBody bodies[]);
 ASX afxUnit         AfxInvokeBodies(afxSimulation sim, afxUnit first, afxUnit cnt, afxBool(*f)(afxBody, void*), void *udd);
+ASX afxUnit         AfxInvokeBodiesParallel(afxSimulation sim, afxUnit first, afxUnit cnt, afxUnit grain, afxParallelFlags flags, afxBool(*f)(afxBody, void*), void *udd);
 
 ASX afxError        AfxRollSimCommands(afxSimulation sim, asxSubmission* ctrl, afxUnit cnt, afxContext contexts[]);
 
@@ -42,6 +42,9 @@ ASX void        AfxRecenterBodyMotiveClocks(afxBody bod, afxReal currClock);
 /// Update all the motors affecting a particular puppet.
 ASX void        AfxUpdateBodyMotives(afxBody bod, afxReal newClock);
 
+/// Updates the motives of many bodies in parallel on the system service. Bodies must be distinct.
+ASX void        AfxUpdateBodiesMotives(afxUnit cnt, afxBody bodies[], afxReal newClock);
+
 ASX void        AfxPurgeTerminatedMotives(afxBody bod);
 
 AFX_DEFINE_STRUCT(afxAnimSampleContext)